@@ -0,0 +1,120 @@
+/* Copyright 2021 Ole Kliemann, Malte Kliemann
+ *
+ * This file is part of DrMock.
+ *
+ * DrMock is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DrMock is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DrMock.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <string>
+
+#include <DrMock/Test.h>
+#include <DrMock/mock/Method.h>
+
+using namespace drmock;
+
+class Dummy {};
+
+void
+addQueueRows()
+{
+  drtest::addColumn<bool>("ordered");
+  drtest::addColumn<int>("size");
+  for (bool ordered : {true, false})
+  {
+    for (int n = 1; n <= 100000; n *= 10)
+    {
+      drtest::addRow(
+          std::string{ordered ? "ordered" : "unordered"} + "/" + std::to_string(n),
+          ordered, n
+        );
+    }
+  }
+}
+
+DRTEST_DATA(configure)
+{
+  addQueueRows();
+}
+
+DRTEST_BENCHMARK(configure)
+{
+  // Time per round: Configure `size` behaviors without calling the
+  // method. This is the setup contained in every round of `dispatch`.
+  DRTEST_FETCH(bool, ordered);
+  DRTEST_FETCH(int, size);
+  drtest::measure([ordered, size] () {
+      Method<Dummy, int, int> m{"f"};
+      m.enforce_order(ordered);
+      for (int i = 0; i < size; ++i)
+      {
+        m.push().expects(i).returns(i);
+      }
+      drtest::doNotOptimize(m);
+    });
+}
+
+DRTEST_DATA(dispatch)
+{
+  addQueueRows();
+}
+
+DRTEST_BENCHMARK(dispatch)
+{
+  // Time per round: Configure `size` behaviors and consume them. The
+  // unordered queue is consumed back to front. Consuming a behavior
+  // removes it from the queue, so the configuration can't be hoisted
+  // out of the round; subtract the time of `configure` to get the cost
+  // of the calls alone.
+  DRTEST_FETCH(bool, ordered);
+  DRTEST_FETCH(int, size);
+  drtest::measure([ordered, size] () {
+      Method<Dummy, int, int> m{"f"};
+      m.enforce_order(ordered);
+      for (int i = 0; i < size; ++i)
+      {
+        m.push().expects(i).returns(i);
+      }
+      for (int i = 0; i < size; ++i)
+      {
+        drtest::doNotOptimize(m.call(ordered ? i : size - 1 - i));
+      }
+      drtest::doNotOptimize(m.verify());
+    });
+}
+
+DRTEST_DATA(persistentDispatch)
+{
+  drtest::addColumn<int>("size");
+  for (int n = 1; n <= 100000; n *= 10)
+  {
+    drtest::addRow(std::to_string(n), n);
+  }
+}
+
+DRTEST_BENCHMARK(persistentDispatch)
+{
+  // Time per call of the last of `size` persistent behaviors of an
+  // unordered queue.
+  DRTEST_FETCH(int, size);
+  Method<Dummy, int, int> m{"f"};
+  m.enforce_order(false);
+  for (int i = 0; i < size; ++i)
+  {
+    m.push().expects(i).returns(i).persists();
+  }
+  // Make sure that the measured call matches.
+  DRTEST_ASSERT_EQ(*m.call(size - 1), size - 1);
+  DRTEST_ASSERT_EQ(m.num_failed_calls(), std::size_t{0});
+  drtest::measure([&m, size] () { drtest::doNotOptimize(m.call(size - 1)); });
+}
@@ -0,0 +1,167 @@
+/* Copyright 2021 Ole Kliemann, Malte Kliemann
+ *
+ * This file is part of DrMock.
+ *
+ * DrMock is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DrMock is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DrMock.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <DrMock/Test.h>
+#include <DrMock/mock/Method.h>
+
+using namespace drmock;
+
+class Dummy {};
+
+constexpr int calls_per_thread = 1000;
+
+// Threads which call `work` once per round. The threads are started
+// once, so that their start-up isn't timed; `run` releases all of them
+// at once and waits until they're done.
+class Workers
+{
+public:
+  Workers(int num_threads, std::function<void()> work)
+  :
+    work_{std::move(work)}
+  {
+    for (int i = 0; i < num_threads; ++i)
+    {
+      threads_.emplace_back([this] () { loop(); });
+    }
+  }
+
+  ~Workers()
+  {
+    done_.store(true, std::memory_order_release);
+    for (auto& t : threads_)
+    {
+      t.join();
+    }
+  }
+
+  void run()
+  {
+    pending_.store(threads_.size(), std::memory_order_relaxed);
+    round_.fetch_add(1, std::memory_order_release);
+    while (pending_.load(std::memory_order_acquire) != 0)
+    {
+      std::this_thread::yield();
+    }
+  }
+
+private:
+  void loop()
+  {
+    std::size_t round = 0;
+    while (true)
+    {
+      while (round_.load(std::memory_order_acquire) == round)
+      {
+        if (done_.load(std::memory_order_acquire))
+        {
+          return;
+        }
+        std::this_thread::yield();
+      }
+      ++round;
+      work_();
+      pending_.fetch_sub(1, std::memory_order_release);
+    }
+  }
+
+  std::function<void()> work_;
+  std::atomic<std::size_t> round_{0};
+  std::atomic<std::size_t> pending_{0};
+  std::atomic<bool> done_{false};
+  std::vector<std::thread> threads_{};
+};
+
+DRTEST_DATA(concurrentCalls)
+{
+  drtest::addColumn<bool>("ordered");
+  drtest::addColumn<int>("threads");
+  for (bool ordered : {false, true})
+  {
+    for (int n = 1; n <= 64; n *= 2)
+    {
+      drtest::addRow(
+          std::string{ordered ? "ordered" : "persistent"} + "/" + std::to_string(n),
+          ordered, n
+        );
+    }
+  }
+}
+
+DRTEST_BENCHMARK(concurrentCalls)
+{
+  // Time per round of `calls_per_thread` calls on every thread.
+  //
+  // persistent: All calls match a single persistent behavior (the
+  // read-only fast path).
+  //
+  // ordered: The ordered queue holds one behavior per thread, each
+  // expecting `calls_per_thread` calls, so that the threads contend
+  // for the claims of the front behavior and for advancing the front.
+  // The method is replaced before every round; this setup is linear in
+  // the number of threads and negligible against the calls.
+  DRTEST_FETCH(bool, ordered);
+  DRTEST_FETCH(int, threads);
+  auto make_method = [ordered, threads] () {
+      auto m = std::make_unique<Method<Dummy, int, int>>("f");
+      m->concurrent(true);
+      if (ordered)
+      {
+        m->enforce_order(true);
+        for (int i = 0; i < threads; ++i)
+        {
+          m->push().expects().times(calls_per_thread).returns(1);
+        }
+      }
+      else
+      {
+        m->push().expects(1).persists().returns(1);
+      }
+      return m;
+    };
+
+  // `m` is only replaced while the workers wait.
+  auto m = make_method();
+  Workers workers{threads, [&m] () {
+      for (int i = 0; i < calls_per_thread; ++i)
+      {
+        drtest::doNotOptimize(m->call(1));
+      }
+    }};
+
+  // Make sure that the measured calls match.
+  workers.run();
+  DRTEST_ASSERT_EQ(m->num_failed_calls(), std::size_t{0});
+
+  drtest::measure([&workers, &m, &make_method, ordered] () {
+      if (ordered)
+      {
+        m = make_method();
+      }
+      workers.run();
+    });
+  DRTEST_ASSERT_EQ(m->num_failed_calls(), std::size_t{0});
+}
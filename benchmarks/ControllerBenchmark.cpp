@@ -0,0 +1,56 @@
+/* Copyright 2021 Ole Kliemann, Malte Kliemann
+ *
+ * This file is part of DrMock.
+ *
+ * DrMock is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DrMock is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DrMock.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <DrMock/Test.h>
+#include <DrMock/mock/Controller.h>
+#include <DrMock/mock/Method.h>
+
+using namespace drmock;
+
+class Dummy {};
+
+DRTEST_DATA(verify)
+{
+  drtest::addColumn<int>("methods");
+  for (int n = 10; n <= 10000; n *= 10)
+  {
+    drtest::addRow(std::to_string(n), n);
+  }
+}
+
+DRTEST_BENCHMARK(verify)
+{
+  // Every method has ten unsatisfied behaviors.
+  DRTEST_FETCH(int, methods);
+  std::vector<std::shared_ptr<IMethod>> collection{};
+  for (int i = 0; i < methods; ++i)
+  {
+    auto method = std::make_shared<Method<Dummy, int, int>>(std::to_string(i));
+    for (int j = 0; j < 10; ++j)
+    {
+      method->push().expects(j).returns(j);
+    }
+    collection.push_back(std::move(method));
+  }
+  Controller controller{collection};
+  drtest::measure([&controller] () { drtest::doNotOptimize(controller.verify()); });
+}
@@ -0,0 +1,87 @@
+/* Copyright 2021 Ole Kliemann, Malte Kliemann
+ *
+ * This file is part of DrMock.
+ *
+ * DrMock is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DrMock is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DrMock.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <DrMock/Test.h>
+#include <DrMock/mock/detail/IsEqual.h>
+
+using namespace drmock::detail;
+
+class Base
+{
+public:
+  virtual ~Base() = default;
+};
+
+class Derived : public Base
+{
+public:
+  Derived(int x)
+  :
+    x_{x}
+  {}
+
+  bool operator==(const Derived& other) const
+  {
+    return x_ == other.x_;
+  }
+
+private:
+  int x_;
+};
+
+DRTEST_DATA(nestedContainers)
+{
+  drtest::addColumn<int>("size");
+  for (int n = 10; n <= 1000; n *= 10)
+  {
+    drtest::addRow(std::to_string(n), n);
+  }
+}
+
+DRTEST_BENCHMARK(nestedContainers)
+{
+  // Compare two equal vectors of `size` maps with `size` entries each.
+  using Nested = std::vector<std::map<std::string, std::vector<int>>>;
+  DRTEST_FETCH(int, size);
+  Nested lhs(size);
+  for (auto& map : lhs)
+  {
+    for (int i = 0; i < size; ++i)
+    {
+      map[std::to_string(i)] = {i, i + 1, i + 2};
+    }
+  }
+  Nested rhs = lhs;
+  drtest::measure([&lhs, &rhs] () { drtest::doNotOptimize(IsEqual<Nested>{}(lhs, rhs)); });
+}
+
+DRTEST_BENCHMARK(polymorphicPointers)
+{
+  using Pointer = std::shared_ptr<Base>;
+  using Tuple = std::tuple<Pointer, Pointer>;
+  using IsEqualTuple = IsEqual<Tuple, std::tuple<std::shared_ptr<Derived>, std::shared_ptr<Derived>>>;
+  Tuple lhs{std::make_shared<Derived>(1), std::make_shared<Derived>(2)};
+  Tuple rhs{std::make_shared<Derived>(1), std::make_shared<Derived>(2)};
+  drtest::measure([&lhs, &rhs] () { drtest::doNotOptimize(IsEqualTuple{}(lhs, rhs)); });
+}
@@ -0,0 +1,39 @@
+# Copyright 2021 Ole Kliemann, Malte Kliemann
+#
+# This file is part of DrMock.
+#
+# DrMock is free software: you can redistribute it and/or modify it
+# under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# DrMock is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with DrMock.  If not, see <https://www.gnu.org/licenses/>.
+
+# Merge the JSON arrays written by the benchmark executables into one
+# JSON object, keyed by the name of the executable:
+#
+#   {
+#     "BehaviorQueueBenchmark": [ ... ],
+#     ...
+#   }
+#
+# Usage: cmake -DRESULTS=<file1;file2;...> -DOUTPUT=<file> -P MergeResults.cmake
+
+set(content "{")
+set(separator "\n")
+list(SORT RESULTS)
+foreach (path ${RESULTS})
+    get_filename_component(name ${path} NAME_WE)
+    file(READ ${path} array)
+    string(STRIP "${array}" array)
+    string(APPEND content "${separator}\"${name}\": ${array}")
+    set(separator ",\n")
+endforeach()
+string(APPEND content "\n}\n")
+file(WRITE ${OUTPUT} "${content}")
@@ -0,0 +1,64 @@
+/* Copyright 2021 Ole Kliemann, Malte Kliemann
+ *
+ * This file is part of DrMock.
+ *
+ * DrMock is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DrMock is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DrMock.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <memory>
+
+#include <DrMock/Test.h>
+#include <DrMock/mock/Method.h>
+
+using namespace drmock;
+
+class Dummy {};
+
+class IFoo
+{
+public:
+  virtual ~IFoo() = default;
+  virtual int f(int) = 0;
+};
+
+class Foo : public IFoo
+{
+public:
+  int f(int x) override
+  {
+    return x;
+  }
+};
+
+DRTEST_BENCHMARK(virtualCall)
+{
+  // Baseline for `Method::call`.
+  std::unique_ptr<IFoo> foo = std::make_unique<Foo>();
+  drtest::doNotOptimize(foo);
+  drtest::measure([&foo] () { drtest::doNotOptimize(foo->f(1)); });
+}
+
+DRTEST_BENCHMARK(stubCall)
+{
+  Method<Dummy, int, int> m{"f"};
+  m.push().expects().returns(1).persists();
+  drtest::measure([&m] () { drtest::doNotOptimize(m.call(1)); });
+}
+
+DRTEST_BENCHMARK(matchingCall)
+{
+  Method<Dummy, int, int> m{"f"};
+  m.push().expects(1).returns(1).persists();
+  drtest::measure([&m] () { drtest::doNotOptimize(m.call(1)); });
+}
@@ -0,0 +1,58 @@
+/* Copyright 2021 Ole Kliemann, Malte Kliemann
+ *
+ * This file is part of DrMock.
+ *
+ * DrMock is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DrMock is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DrMock.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <string>
+
+#include <DrMock/Test.h>
+#include <DrMock/mock/Method.h>
+
+using namespace drmock;
+
+class Dummy {};
+
+DRTEST_DATA(transition)
+{
+  drtest::addColumns<int, int>("slots", "states");
+  drtest::addRow("1x10", 1, 10);
+  drtest::addRow("10x100", 10, 100);
+  drtest::addRow("100x1000", 100, 1000);
+}
+
+DRTEST_BENCHMARK(transition)
+{
+  // Every slot cycles through its states; calling with `i` advances
+  // slot `i`.
+  DRTEST_FETCH(int, slots);
+  DRTEST_FETCH(int, states);
+  auto state_name = [] (int j) { return j == 0 ? std::string{} : std::to_string(j); };
+  Method<Dummy, void, int> m{"f"};
+  auto& state = m.state();
+  for (int i = 0; i < slots; ++i)
+  {
+    for (int j = 0; j < states; ++j)
+    {
+      state.transition(std::to_string(i), state_name(j), state_name((j + 1) % states), i);
+    }
+  }
+  int i = 0;
+  drtest::measure([&m, &i, slots] () {
+      m.call(i);
+      i = (i + 1) % slots;
+    });
+  DRTEST_ASSERT(m.verify());
+}
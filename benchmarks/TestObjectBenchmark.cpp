@@ -0,0 +1,65 @@
+/* Copyright 2021 Ole Kliemann, Malte Kliemann
+ *
+ * This file is part of DrMock.
+ *
+ * DrMock is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DrMock is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DrMock.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <string>
+#include <vector>
+
+#include <DrMock/Test.h>
+
+void
+addRows()
+{
+  drtest::addColumns<int, std::string, std::vector<int>>("number", "text", "numbers");
+  drtest::addRow("row", 1, std::string(100, 'x'), std::vector<int>(100, 1));
+}
+
+DRTEST_DATA(fetch)
+{
+  addRows();
+}
+
+DRTEST_BENCHMARK(fetch)
+{
+  // Copy all three columns of the current row.
+  drtest::measure([] () {
+      DRTEST_FETCH(int, number);
+      DRTEST_FETCH(std::string, text);
+      DRTEST_FETCH(std::vector<int>, numbers);
+      drtest::doNotOptimize(number);
+      drtest::doNotOptimize(text.data());
+      drtest::doNotOptimize(numbers.data());
+    });
+}
+
+DRTEST_DATA(fetchRef)
+{
+  addRows();
+}
+
+DRTEST_BENCHMARK(fetchRef)
+{
+  // Access all three columns of the current row without copying.
+  drtest::measure([] () {
+      DRTEST_FETCH_REF(int, number);
+      DRTEST_FETCH_REF(std::string, text);
+      DRTEST_FETCH_REF(std::vector<int>, numbers);
+      drtest::doNotOptimize(number);
+      drtest::doNotOptimize(text.data());
+      drtest::doNotOptimize(numbers.data());
+    });
+}
@@ -0,0 +1,127 @@
+# Copyright 2021 Ole Kliemann, Malte Kliemann
+#
+# This file is part of DrMock.
+#
+# DrMock is free software: you can redistribute it and/or modify it
+# under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# DrMock is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with DrMock.  If not, see <https://www.gnu.org/licenses/>.
+
+# cmake -DGENERATOR=<generator>
+#       -DHEADER=<header>
+#       -DMOCK_HEADER=<mock_header>
+#       -DMOCK_SOURCE=<mock_source>
+#       -DSNAPSHOT=<snapshot>
+#       -DPRIVATE_HEADER=<private_header>
+#       -DPRIVATE_SOURCE=<private_source>
+#       -DINPUT_CLASS=<input_class>
+#       -DOUTPUT_CLASS=<output_class>
+#       -DOPTIONS=<option1;option2;...>
+#       -DFLAGS=<flag1;flag2;...>
+#       -DPREPROCESSOR=<command;arg1;arg2;...>
+#       -DSTAMP=<stamp>
+#       -P DrMockGenerate.cmake
+#
+# Script used by `drmock_library2` for calling `drmock-generator`.
+#
+# Runs `GENERATOR` on `HEADER`, passing `OPTIONS` and `FLAGS`, unless
+# the mock is cached: The interface header is preprocessed by running
+# `PREPROCESSOR` with `FLAGS` and the header, and whitespace is
+# collapsed. The SHA256 of the result and of the generator's arguments
+# is stored next to the mock header. If the hash is unchanged and the
+# mock header and source exist, the generator is skipped and the mock
+# files are left untouched. If the preprocessor fails, the raw content
+# of the header is hashed instead.
+#
+# The mock library doesn't compile `MOCK_SOURCE`, which includes
+# `HEADER` and would thus be recompiled whenever `HEADER` changes.
+# Instead, `HEADER` is copied to `SNAPSHOT` whenever the generator runs,
+# and `PRIVATE_HEADER` and `PRIVATE_SOURCE` are copies of the mock
+# header and source which include `SNAPSHOT` and `PRIVATE_HEADER` in
+# place of `HEADER` and `MOCK_HEADER`. These files are only written if
+# their content changes, so a cached mock is not recompiled. (If the
+# generator includes `HEADER` under a different path, the copies include
+# `HEADER` and are recompiled as before.)
+#
+# Finally, `STAMP` is touched.
+
+cmake_minimum_required(VERSION 3.13)
+
+set(command
+    ${GENERATOR}
+    ${HEADER}
+    ${MOCK_HEADER}
+    --input-class ${INPUT_CLASS}
+    --output-class ${OUTPUT_CLASS}
+    ${OPTIONS}
+    # Note: Compiler flags _must_ follow the ``--flags`` argument!
+    --flags ${FLAGS}
+)
+
+execute_process(
+    COMMAND ${PREPROCESSOR} ${FLAGS} ${HEADER}
+    RESULT_VARIABLE result
+    OUTPUT_VARIABLE interface
+    ERROR_QUIET
+)
+if (NOT result EQUAL 0)
+    file(READ ${HEADER} interface)
+endif()
+string(REGEX REPLACE "[ \t\r\n]+" " " interface "${interface}")
+string(SHA256 hash "${command}\n${interface}")
+
+set(hash_file "${MOCK_HEADER}.sha256")
+set(cached FALSE)
+if (EXISTS ${hash_file} AND EXISTS ${MOCK_HEADER} AND EXISTS ${MOCK_SOURCE})
+    file(READ ${hash_file} cached_hash)
+    if (cached_hash STREQUAL hash)
+        set(cached TRUE)
+    endif()
+endif()
+
+if (NOT cached)
+    message(STATUS "Mocking ${HEADER}...")
+    file(REMOVE ${hash_file})
+    execute_process(COMMAND ${command} RESULT_VARIABLE result)
+    if (NOT result EQUAL 0)
+        message(FATAL_ERROR "drmock-generator failed on ${HEADER}")
+    endif()
+    file(WRITE ${hash_file} "${hash}")
+endif()
+
+# Write `content` to `path`, unless `path` already holds `content`.
+function(_write_if_changed path content)
+    if (EXISTS ${path})
+        file(READ ${path} old_content)
+        if (old_content STREQUAL content)
+            return()
+        endif()
+    endif()
+    file(WRITE ${path} "${content}")
+endfunction()
+
+# The snapshot is only updated along with the mock, so that changes
+# which don't affect the hash don't recompile the mock.
+if (NOT cached OR NOT EXISTS ${SNAPSHOT})
+    file(READ ${HEADER} snapshot_content)
+    _write_if_changed(${SNAPSHOT} "${snapshot_content}")
+endif()
+file(READ ${MOCK_HEADER} private_header_content)
+string(REPLACE "\"${HEADER}\"" "\"${SNAPSHOT}\"" private_header_content "${private_header_content}")
+_write_if_changed(${PRIVATE_HEADER} "${private_header_content}")
+file(READ ${MOCK_SOURCE} private_source_content)
+string(REPLACE "\"${HEADER}\"" "\"${SNAPSHOT}\"" private_source_content "${private_source_content}")
+string(REPLACE "\"${MOCK_HEADER}\"" "\"${PRIVATE_HEADER}\"" private_source_content "${private_source_content}")
+_write_if_changed(${PRIVATE_SOURCE} "${private_source_content}")
+
+get_filename_component(stamp_directory "${STAMP}" DIRECTORY)
+file(MAKE_DIRECTORY "${stamp_directory}")
+file(TOUCH "${STAMP}")
@@ -0,0 +1,200 @@
+# Copyright 2021 Ole Kliemann, Malte Kliemann
+#
+# This file is part of DrMock.
+#
+# DrMock is free software: you can redistribute it and/or modify it
+# under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# DrMock is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with DrMock.  If not, see <https://www.gnu.org/licenses/>.
+
+# cmake -DMOCK_HEADERS=<header1;header2;...>
+#       -DEXTERN_HEADERS=<extern1;extern2;...>
+#       -DUNIT=<unit>
+#       -DSTAMP=<stamp>
+#       -P DrMockInstantiations.cmake
+#
+# Script used by `drmock_library2(... EXTERN_TEMPLATES)`.
+#
+# Every mock header written by `drmock-generator` declares its
+# instantiations of `drmock::Method` extern. Their first template
+# parameter is the mocked class, so they are never repeated across
+# mock headers. But the templates which only depend on the parameter
+# types of a method (the matching handler `MakeTupleOfMatchers` and the
+# call journal `Journal`) are instantiated again by every mock which has
+# a method with the same parameter types.
+#
+# For every parameter list which occurs in more than one of the
+# `MOCK_HEADERS`, this script writes an `extern template` declaration
+# of these templates into the `EXTERN_HEADERS` of the mocks that use
+# it, and their instantiation into `UNIT`. Parameter lists which
+# contain a reference type, and declarations which aren't at global
+# scope, are skipped. Files are only rewritten if their content
+# changes, so that unchanged mocks are not recompiled. Finally, `STAMP`
+# is touched.
+
+cmake_minimum_required(VERSION 3.17)
+
+# Split the template argument list `text` at top-level commas.
+function(_drmock_split_template_args text result)
+    set(args)
+    set(current "")
+    set(depth 0)
+    string(LENGTH "${text}" length)
+    set(i 0)
+    while (i LESS length)
+        string(SUBSTRING "${text}" ${i} 1 c)
+        if (c STREQUAL "<" OR c STREQUAL "(")
+            math(EXPR depth "${depth} + 1")
+        elseif (c STREQUAL ">" OR c STREQUAL ")")
+            math(EXPR depth "${depth} - 1")
+        endif()
+        if (c STREQUAL "," AND depth EQUAL 0)
+            string(STRIP "${current}" current)
+            list(APPEND args "${current}")
+            set(current "")
+        else()
+            string(APPEND current "${c}")
+        endif()
+        math(EXPR i "${i} + 1")
+    endwhile()
+    string(STRIP "${current}" current)
+    if (NOT current STREQUAL "")
+        list(APPEND args "${current}")
+    endif()
+    set(${result} "${args}" PARENT_SCOPE)
+endfunction()
+
+# Write `content` to `path` unless `path` already has this content.
+function(_drmock_write_if_different path content)
+    if (EXISTS "${path}")
+        file(READ "${path}" old_content)
+        if (old_content STREQUAL content)
+            return()
+        endif()
+    endif()
+    file(WRITE "${path}" "${content}")
+endfunction()
+
+set(header_comment "// Generated by drmock_library2. Do not edit.\n")
+
+# Collect the parameter lists of every mock header. The parameter lists
+# are identified by index; `keys` holds the parameter list as string,
+# `key<i>_headers` the mock headers which use it.
+set(keys)
+set(declaration_regex "extern template class (::)?drmock::Method<[^\n]*>")
+foreach (header ${MOCK_HEADERS})
+    file(READ "${header}" content)
+    # Semicolons would be interpreted as list separators.
+    string(REPLACE ";" "" content "${content}")
+    # Only declarations at global scope are used. The spelling of the
+    # types in a declaration inside a namespace may depend on that
+    # namespace, so it can't be copied into the `EXTERN_HEADERS` and the
+    # `UNIT`, which are at global scope. The scope is determined by
+    # counting the braces in front of the declaration.
+    set(declarations)
+    set(depth 0)
+    set(rest "${content}")
+    while (TRUE)
+        string(REGEX MATCH "${declaration_regex}" declaration "${rest}")
+        if (declaration STREQUAL "")
+            break()
+        endif()
+        string(FIND "${rest}" "${declaration}" position)
+        string(SUBSTRING "${rest}" 0 ${position} prefix)
+        string(REGEX MATCHALL "{" opening "${prefix}")
+        string(REGEX MATCHALL "}" closing "${prefix}")
+        list(LENGTH opening num_opening)
+        list(LENGTH closing num_closing)
+        math(EXPR depth "${depth} + ${num_opening} - ${num_closing}")
+        if (depth EQUAL 0)
+            list(APPEND declarations "${declaration}")
+        endif()
+        string(LENGTH "${declaration}" length)
+        math(EXPR position "${position} + ${length}")
+        string(SUBSTRING "${rest}" ${position} -1 rest)
+    endwhile()
+    if (NOT declarations)
+        message(WARNING
+            "DrMockInstantiations: ${header} contains no `extern template` "
+            "declarations of `drmock::Method` at global scope; its "
+            "templates are not shared")
+    endif()
+    foreach (declaration ${declarations})
+        string(REGEX REPLACE
+            "^extern template class (::)?drmock::Method<(.*)>$" "\\2"
+            signature "${declaration}")
+        string(REGEX REPLACE "[ \t\r\n]+" " " signature "${signature}")
+        _drmock_split_template_args("${signature}" args)
+        # Remove the class and the return type.
+        list(REMOVE_AT args 0 1)
+        set(skip FALSE)
+        foreach (arg ${args})
+            if (arg MATCHES "&$")
+                set(skip TRUE)
+            endif()
+        endforeach()
+        if (skip)
+            continue()
+        endif()
+        list(JOIN args ", " key)
+        if (key STREQUAL "")
+            # Empty list elements are dropped by `foreach`.
+            set(key "-")
+        endif()
+        list(FIND keys "${key}" index)
+        if (index EQUAL -1)
+            list(LENGTH keys index)
+            list(APPEND keys "${key}")
+            set(key${index}_headers)
+        endif()
+        list(APPEND key${index}_headers "${header}")
+        list(REMOVE_DUPLICATES key${index}_headers)
+    endforeach()
+endforeach()
+
+# Write the declarations and the instantiation unit.
+set(unit_includes)
+set(unit_instantiations)
+foreach (header ${MOCK_HEADERS})
+    set(extern_${header} "${header_comment}")
+endforeach()
+set(index 0)
+foreach (key ${keys})
+    list(LENGTH key${index}_headers count)
+    if (count GREATER 1)
+        if (key STREQUAL "-")
+            set(key "")
+        endif()
+        set(matchers "struct ::drmock::detail::MakeTupleOfMatchers<std::tuple<${key}>>")
+        set(journal "class ::drmock::detail::Journal<${key}>")
+        foreach (header ${key${index}_headers})
+            string(APPEND extern_${header} "extern template ${matchers};\nextern template ${journal};\n")
+        endforeach()
+        list(GET key${index}_headers 0 first)
+        list(APPEND unit_includes "${first}")
+        string(APPEND unit_instantiations "template ${matchers};\ntemplate ${journal};\n")
+    endif()
+    math(EXPR index "${index} + 1")
+endforeach()
+
+foreach (header extern_header IN ZIP_LISTS MOCK_HEADERS EXTERN_HEADERS)
+    _drmock_write_if_different("${extern_header}" "${extern_${header}}")
+endforeach()
+
+list(REMOVE_DUPLICATES unit_includes)
+set(unit_content "${header_comment}\n")
+foreach (header ${unit_includes})
+    string(APPEND unit_content "#include \"${header}\"\n")
+endforeach()
+string(APPEND unit_content "\n${unit_instantiations}")
+_drmock_write_if_different("${UNIT}" "${unit_content}")
+
+file(TOUCH "${STAMP}")
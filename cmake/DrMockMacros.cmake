@@ -15,6 +15,10 @@
 # You should have received a copy of the GNU General Public License
 # along with DrMock.  If not, see <https://www.gnu.org/licenses/>.
 
+# Directory of this file; used for locating the scripts that are
+# installed alongside it.
+set(_DRMOCK_MACROS_DIR ${CMAKE_CURRENT_LIST_DIR})
+
 set(_DRMOCK_FILE_REGEX_DEFAULT_INPUT "I([a-zA-Z0-9].*)")
 set(_DRMOCK_FILE_REGEX_DEFAULT_OUTPUT "\\1Mock")
 
@@ -29,6 +33,7 @@ endmacro()
 #             [LIBS lib1 [lib2 [lib3 ...]]]
 #             [OPTIONS opt1 [opt2 [opt3 ...]]]
 #             [RESOURCES res1 [res2 [res3 ...]]]
+#             [SHARDS num_shards]
 # )
 #
 # Create a test executable from every element of TESTS and link it
@@ -38,11 +43,15 @@ endmacro()
 #
 # The RESOURCES parameter may be used to include other source files
 # `res1`, etc. in the executable.
+#
+# If SHARDS is specified, every executable is registered as
+# `num_shards` tests `<name>_shard<i>`, each of which runs one shard of
+# the executable's tests.
 function(drmock_test)
     cmake_parse_arguments(
         ARGS
         ""
-        ""
+        "SHARDS"
         "LIBS;TESTS;OPTIONS;RESOURCES"
         ${ARGN}
     )
@@ -62,7 +71,17 @@ function(drmock_test)
             DrMock::DrMock
             ${ARGS_LIBS}
         )
-        add_test(NAME ${name} COMMAND ${name})
+        if (ARGS_SHARDS)
+            math(EXPR last_shard "${ARGS_SHARDS} - 1")
+            foreach (i RANGE ${last_shard})
+                add_test(NAME ${name}_shard${i} COMMAND ${name})
+                set_tests_properties(${name}_shard${i} PROPERTIES
+                    ENVIRONMENT
+                    "DRTEST_SHARD_INDEX=${i};DRTEST_SHARD_COUNT=${ARGS_SHARDS}")
+            endforeach()
+        else()
+            add_test(NAME ${name} COMMAND ${name})
+        endif()
         if (NOT ARGS_OPTIONS)
             target_compile_options(${name} PRIVATE ${ARGS_OPTIONS})
         endif()
@@ -81,6 +100,8 @@ endfunction()
 #                [INCLUDE include1 [include2 ...]]
 #                [FRAMEWORKS framework1 [framework2 ...]]
 #                [OPTIONS option1 [option2 ...]]
+#                [PRECOMPILE_HEADERS]
+#                [EXTERN_TEMPLATES]
 #
 # Create a library `target` that contains mock objects for the
 # specified header files.
@@ -95,6 +116,10 @@ endfunction()
 # Note that since `drmock_library` is implemented using
 # `drmock_library2`, it may raise errors labled `drmock_library2`.
 #
+# The preprocessed HEADERS are hashed and a mock is only regenerated if
+# the hash (or the generator call) changed. The mock is still recompiled
+# whenever its header changes. See `DrMockGenerate.cmake` for details.
+#
 # TARGET
 #     The name of the library that is created.
 #
@@ -150,11 +175,23 @@ endfunction()
 #
 # OPTIONS
 #     A list of additional options passed to `drmock-generator`.
+#
+# PRECOMPILE_HEADERS
+#     If set, `DrMock/Mock.h` is precompiled for the sources of
+#     `TARGET`.
+#
+# EXTERN_TEMPLATES
+#     If set, the templates which only depend on the parameter types of
+#     a mocked method (and not on the mocked class) are instantiated
+#     only once per `TARGET` for every parameter list that occurs in
+#     more than one of the HEADERS, and declared `extern` in the mock
+#     sources. See `DrMockInstantiations.cmake` for details.
+
 
 function(drmock_library)
     cmake_parse_arguments(
         ARGS
-        ""
+        "PRECOMPILE_HEADERS;EXTERN_TEMPLATES"
         "TARGET;IFILE;MOCKFILE;ICLASS;MOCKCLASS"
         "HEADERS;LIBS;QTMODULES;INCLUDE;FRAMEWORKS;OPTIONS;FLAGS"
         ${ARGN}
@@ -195,7 +232,16 @@ function(drmock_library)
         list(APPEND output_classes ${ARGS_MOCKCLASS})
     endforeach()
 
-    drmock_library2(TARGET ${ARGS_TARGET}
+    set(flags)
+    if (ARGS_PRECOMPILE_HEADERS)
+        list(APPEND flags PRECOMPILE_HEADERS)
+    endif()
+    if (ARGS_EXTERN_TEMPLATES)
+        list(APPEND flags EXTERN_TEMPLATES)
+    endif()
+
+    drmock_library2(${flags}
+                    TARGET ${ARGS_TARGET}
                     HEADERS ${ARGS_HEADERS}
                     MOCK_HEADER_PATHS ${mock_header_paths}
                     MOCK_SOURCE_PATHS ${mock_source_paths}
@@ -221,6 +267,8 @@ endfunction()
 #                 [INCLUDE include1 [include2 ...]]
 #                 [FRAMEWORKS framework1 [framework2 ...]]
 #                 [OPTIONS option1 [option2 ...]]
+#                 [PRECOMPILE_HEADERS]
+#                 [EXTERN_TEMPLATES]
 #
 # Create a library `target` that contains mock objects for the
 # specified header files.
@@ -247,7 +295,7 @@ endfunction()
 function(drmock_library2)
     cmake_parse_arguments(
         ARGS
-        ""
+        "PRECOMPILE_HEADERS;EXTERN_TEMPLATES"
         "TARGET"
         "HEADERS;MOCK_HEADER_PATHS;MOCK_SOURCE_PATHS;INPUT_CLASSES;OUTPUT_CLASSES;LIBS;QTMODULES;INCLUDE;FRAMEWORKS;OPTIONS;FLAGS"
         ${ARGN}
@@ -307,19 +355,19 @@ function(drmock_library2)
     list(APPEND ARGS_INCLUDE ${include_directories})
     list(APPEND ARGS_INCLUDE ${CMAKE_CURRENT_SOURCE_DIR})
 
-    # Compute some options for the generator call (--iframework,
-    # --clang-library-path)
-    _drmock_options_from_list(
-        OPTION "-I"
-        INPUT ${ARGS_INCLUDE}
-        RESULT generator_option_include_directory
-    )
-    if (ARGS_FRAMEWORKS)
-        _drmock_options_from_list(
-            OPTION "-iframework"
-            INPUT ${ARGS_FRAMEWORKS}
-            RESULT generator_option_iframework
-        )
+    # Compute the flags passed to the generator and to the preprocessor
+    # which computes the hash of the interfaces.
+    set(generator_flags "--std=c++${CMAKE_CXX_STANDARD}" ${ARGS_FLAGS})
+    foreach (include ${ARGS_INCLUDE})
+        list(APPEND generator_flags "-I${include}")
+    endforeach()
+    foreach (framework ${ARGS_FRAMEWORKS})
+        list(APPEND generator_flags "-iframework${framework}")
+    endforeach()
+    if (MSVC)
+        set(preprocessor ${CMAKE_CXX_COMPILER} /EP)
+    else()
+        set(preprocessor ${CMAKE_CXX_COMPILER} -E -P)
     endif()
     if (DEFINED ENV{CLANG_LIBRARY_FILE})
         set(DRMOCK_LIBCLANG_PATH $ENV{CLANG_LIBRARY_FILE})
@@ -335,6 +383,18 @@ function(drmock_library2)
                 /usr/lib/llvm-7/lib
         )
     endif()
+    set(generator_options --clang-library-file ${DRMOCK_LIBCLANG_PATH} ${ARGS_OPTIONS})
+
+    # Lists of the absolute paths to the mock headers, the stamps of the
+    # generator calls and the headers with the `extern template`
+    # declarations (only used if EXTERN_TEMPLATES is set).
+    set(absolute_mock_header_paths)
+    set(generate_stamps)
+    set(extern_header_paths)
+    _drmock_join_paths(RESULT generate_directory
+                       PATHS ${CMAKE_CURRENT_BINARY_DIR} DrMockGenerate ${ARGS_TARGET})
+    _drmock_join_paths(RESULT instantiations_directory
+                       PATHS ${CMAKE_CURRENT_BINARY_DIR} DrMockInstantiations ${ARGS_TARGET})
 
     foreach (header mock_header_path mock_source_path input_class output_class
              IN ZIP_LISTS ARGS_HEADERS ARGS_MOCK_HEADER_PATHS ARGS_MOCK_SOURCE_PATHS
@@ -347,38 +407,100 @@ function(drmock_library2)
         _drmock_join_paths(
             RESULT path_from_working_dir_to_output_header
             PATHS ${CMAKE_CURRENT_BINARY_DIR} ${mock_header_path})
-
-        # Setup drmock-generator arguments.
-        set(command)
-        list(APPEND command drmock-generator)
-        list(APPEND command ${absolute_path_to_header})
-        list(APPEND command ${path_from_working_dir_to_output_header})
-        list(APPEND command --input-class \"${input_class}\")
-        list(APPEND command --output-class \"${output_class}\")
-        list(APPEND command --clang-library-file ${DRMOCK_LIBCLANG_PATH})
-        list(APPEND command ${ARGS_OPTIONS})
-        # Note: Compiler flags _must_ follow the ``--flags`` argument!
-        list(APPEND command --flags)
-        list(APPEND command "--std=c++${CMAKE_CXX_STANDARD}")
-        list(APPEND command ${ARGS_FLAGS})
-        list(APPEND command ${generator_option_include_directory})
-        list(APPEND command ${generator_option_iframework})
-        add_custom_command(
-            OUTPUT
-                ${mock_header_path}
-                ${mock_source_path}
-            COMMAND ${command}
-            DEPENDS ${absolute_path_to_header}
+        _drmock_join_paths(
+            RESULT absolute_mock_source_path
+            PATHS ${CMAKE_CURRENT_BINARY_DIR} ${mock_source_path})
+        list(APPEND absolute_mock_header_paths ${path_from_working_dir_to_output_header})
+        list(LENGTH absolute_mock_header_paths index)
+        get_filename_component(mock_name ${mock_source_path} NAME_WE)
+
+        # The library compiles private copies of the mock files which
+        # include a snapshot of the interface, so that it only depends
+        # on the interface through the hash of the mock (see
+        # `DrMockGenerate.cmake`).
+        get_filename_component(header_name ${header} NAME)
+        get_filename_component(header_directory ${absolute_path_to_header} DIRECTORY)
+        get_filename_component(mock_header_name ${mock_header_path} NAME)
+        get_filename_component(mock_header_directory ${path_from_working_dir_to_output_header} DIRECTORY)
+        get_filename_component(mock_source_name ${mock_source_path} NAME)
+        set(private_directory ${generate_directory}/${index}_${mock_name})
+        set(snapshot_path ${private_directory}/interface/${header_name})
+        set(private_header_path ${private_directory}/${mock_header_name})
+        set(private_source_path ${private_directory}/${mock_source_name})
+        # Relative includes of the interface and the mock files are
+        # resolved against their original directories.
+        set_source_files_properties(${private_source_path}
+            PROPERTIES INCLUDE_DIRECTORIES "${header_directory};${mock_header_directory}")
+
+        set(stamp_path ${generate_directory}/${index}_${mock_name}.stamp)
+        _drmock_add_generate_command(
+            STAMP ${stamp_path}
+            HEADER ${absolute_path_to_header}
+            MOCK_HEADER ${path_from_working_dir_to_output_header}
+            MOCK_SOURCE ${absolute_mock_source_path}
+            SNAPSHOT ${snapshot_path}
+            PRIVATE_HEADER ${private_header_path}
+            PRIVATE_SOURCE ${private_source_path}
+            INPUT_CLASS ${input_class}
+            OUTPUT_CLASS ${output_class}
+            OPTIONS ${generator_options}
+            FLAGS ${generator_flags}
+            PREPROCESSOR ${preprocessor}
             COMMENT "Mocking ${header}..."
         )
+        list(APPEND generate_stamps ${stamp_path})
 
-        list(APPEND sources ${mock_source_path})
+        list(APPEND sources ${private_source_path})
         if (ARGS_QTMODULES)
             list(APPEND sources ${header})  # Need header when using AUTO_MOC!
         endif()
+
+        if (ARGS_EXTERN_TEMPLATES)
+            # Compile a wrapper which includes the mock source after the
+            # `extern template` declarations instead of the mock source.
+            set(extern_header_path ${instantiations_directory}/${index}_${mock_name}Extern.h)
+            set(wrapper_path ${instantiations_directory}/${index}_${mock_name}.cpp)
+            file(GENERATE
+                OUTPUT ${wrapper_path}
+                CONTENT "#include \"${private_header_path}\"\n#include \"${extern_header_path}\"\n#include \"${private_source_path}\"\n"
+            )
+            set_source_files_properties(${private_source_path} PROPERTIES HEADER_FILE_ONLY ON)
+            set_source_files_properties(${wrapper_path}
+                PROPERTIES INCLUDE_DIRECTORIES "${header_directory};${mock_header_directory}")
+            list(APPEND sources ${wrapper_path})
+            list(APPEND extern_header_paths ${extern_header_path})
+        endif()
     endforeach()
 
+    list(APPEND sources ${generate_stamps})
+
+    if (ARGS_EXTERN_TEMPLATES)
+        # The declarations and the instantiation unit are only rewritten
+        # if they change, so the script's output is the stamp.
+        set(unit_path ${instantiations_directory}/Instantiations.cpp)
+        set(stamp_path ${instantiations_directory}/Instantiations.stamp)
+        add_custom_command(
+            OUTPUT ${stamp_path}
+            BYPRODUCTS ${extern_header_paths} ${unit_path}
+            COMMAND ${CMAKE_COMMAND}
+                "-DMOCK_HEADERS=${absolute_mock_header_paths}"
+                "-DEXTERN_HEADERS=${extern_header_paths}"
+                -DUNIT=${unit_path}
+                -DSTAMP=${stamp_path}
+                -P ${_DRMOCK_MACROS_DIR}/DrMockInstantiations.cmake
+            DEPENDS
+                ${generate_stamps}
+                ${_DRMOCK_MACROS_DIR}/DrMockInstantiations.cmake
+            COMMENT "Collecting template instantiations of ${ARGS_TARGET}..."
+            VERBATIM
+        )
+        list(APPEND sources ${stamp_path} ${unit_path})
+    endif()
+
     add_library(${ARGS_TARGET} SHARED ${sources})
+    if (ARGS_PRECOMPILE_HEADERS)
+        target_precompile_headers(${ARGS_TARGET} PRIVATE <DrMock/Mock.h>)
+    endif()
     _drmock_join_paths(RESULT drmock_directory
                        PATHS ${CMAKE_CURRENT_BINARY_DIR} DrMock)  # Required later.
     target_include_directories(${ARGS_TARGET} PUBLIC ${drmock_directory})
@@ -599,29 +721,64 @@ function(_drmock_compute_path_from_filename)
 endfunction()
 
 
-# _drmock_options_from_list(OPTION <option>
-#                           INPUT <input1>;<input2>;... 
-#                           RESULT <result>)
-#
-# Set `result` to "<option><input1>;<option><input2>;..."
-function(_drmock_options_from_list)
+# _drmock_add_generate_command(STAMP <stamp>
+#                              HEADER <header>
+#                              MOCK_HEADER <mock_header>
+#                              MOCK_SOURCE <mock_source>
+#                              SNAPSHOT <snapshot>
+#                              PRIVATE_HEADER <private_header>
+#                              PRIVATE_SOURCE <private_source>
+#                              INPUT_CLASS <input_class>
+#                              OUTPUT_CLASS <output_class>
+#                              [OPTIONS option1 [option2 ...]]
+#                              [FLAGS flag1 [flag2 ...]]
+#                              PREPROCESSOR command [arg1 ...]
+#                              COMMENT <comment>)
+#
+# Add a custom command which runs `DrMockGenerate.cmake` on `header`
+# and touches `stamp`. The mock header and source, the snapshot of the
+# interface and the private copies of the mock files are byproducts, so
+# they're only rewritten if the hash of their interface changes.
+function(_drmock_add_generate_command)
     cmake_parse_arguments(
         ARGS
         ""
-        "OPTION;RESULT"
-        "INPUT"
+        "STAMP;HEADER;MOCK_HEADER;MOCK_SOURCE;SNAPSHOT;PRIVATE_HEADER;PRIVATE_SOURCE;INPUT_CLASS;OUTPUT_CLASS;COMMENT"
+        "OPTIONS;FLAGS;PREPROCESSOR"
         ${ARGN}
     )
-    _drmock_required_param(ARGS_OPTION
-        "_drmock_options_from_list: OPTION parameter missing")
-    _drmock_required_param(ARGS_RESULT
-        "_drmock_options_from_list: RESULT parameter missing")
-
-    set(_result)
-    foreach (each ${ARGS_INPUT})
-        list(APPEND _result "${ARGS_OPTION}\"${each}\"")
-    endforeach()
-    set(${ARGS_RESULT} ${_result} PARENT_SCOPE)
+    _drmock_required_param(ARGS_STAMP
+        "_drmock_add_generate_command: STAMP parameter missing")
+
+    add_custom_command(
+        OUTPUT ${ARGS_STAMP}
+        BYPRODUCTS
+            ${ARGS_MOCK_HEADER}
+            ${ARGS_MOCK_SOURCE}
+            ${ARGS_SNAPSHOT}
+            ${ARGS_PRIVATE_HEADER}
+            ${ARGS_PRIVATE_SOURCE}
+        COMMAND ${CMAKE_COMMAND}
+            -DGENERATOR=drmock-generator
+            "-DHEADER=${ARGS_HEADER}"
+            "-DMOCK_HEADER=${ARGS_MOCK_HEADER}"
+            "-DMOCK_SOURCE=${ARGS_MOCK_SOURCE}"
+            "-DSNAPSHOT=${ARGS_SNAPSHOT}"
+            "-DPRIVATE_HEADER=${ARGS_PRIVATE_HEADER}"
+            "-DPRIVATE_SOURCE=${ARGS_PRIVATE_SOURCE}"
+            "-DINPUT_CLASS=${ARGS_INPUT_CLASS}"
+            "-DOUTPUT_CLASS=${ARGS_OUTPUT_CLASS}"
+            "-DOPTIONS=${ARGS_OPTIONS}"
+            "-DFLAGS=${ARGS_FLAGS}"
+            "-DPREPROCESSOR=${ARGS_PREPROCESSOR}"
+            -DSTAMP=${ARGS_STAMP}
+            -P ${_DRMOCK_MACROS_DIR}/DrMockGenerate.cmake
+        DEPENDS
+            ${ARGS_HEADER}
+            ${_DRMOCK_MACROS_DIR}/DrMockGenerate.cmake
+        COMMENT ${ARGS_COMMENT}
+        VERBATIM
+    )
 endfunction()
 
 
@@ -19,13 +19,7 @@
 #ifndef DRMOCK_SRC_DRMOCK_MOCK_ABSTRACTBEHAVIOR_H
 #define DRMOCK_SRC_DRMOCK_MOCK_ABSTRACTBEHAVIOR_H
 
-#include <exception>
-#include <memory>
-#include <utility>
-#include <variant>
-
-#include <DrMock/mock/AbstractSignal.h>
-#include <DrMock/mock/detail/IMakeTupleOfMatchers.h>
+#include <DrMock/mock/detail/Production.h>
 
 namespace drmock {
 
@@ -47,18 +41,15 @@ public:
   /**
    * Simulates the method's behavior when called with `args...`.
    *
-   * @returns `std::monostate` (no return value), a pair containing the
-   * return value and/or a Qt signal emit, or an exception pointer (to
-   * the exception the method is supposed to raise)
+   * @returns `std::monostate` (no return value), a pair containing
+   * pointers to the return value and/or a Qt signal emit, or an
+   * exception pointer (to the exception the method is supposed to
+   * raise)
+   *
+   * The pointers point into the storage of `this` and remain valid as
+   * long as `this` does.
    */
-  virtual std::variant<
-      std::monostate,
-      std::pair<
-          std::shared_ptr<typename std::decay<ReturnType>::type>,
-          std::shared_ptr<AbstractSignal<Class>>
-        >,
-      std::exception_ptr
-    > call(const Args&... args) = 0;
+  virtual detail::Production<Class, ReturnType> call(const Args&... args) = 0;
 };
 
 } // namespace drmock
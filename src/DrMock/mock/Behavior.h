@@ -19,14 +19,20 @@
 #ifndef DRMOCK_SRC_DRMOCK_MOCK_BEHAVIOR_H
 #define DRMOCK_SRC_DRMOCK_MOCK_BEHAVIOR_H
 
+#include <atomic>
+#include <cstddef>
 #include <memory>
 #include <optional>
 #include <utility>
 #include <variant>
 
+#include <DrMock/mock/detail/Arena.h>
+#include <DrMock/mock/detail/Counter.h>
 #include <DrMock/mock/detail/MatchPack.h>
 #include <DrMock/mock/detail/IMakeTupleOfMatchers.h>
+#include <DrMock/mock/detail/Production.h>
 #include <DrMock/mock/AbstractSignal.h>
+#include <DrMock/mock/StaticMatchers.h>
 
 namespace drmock {
 
@@ -84,6 +90,24 @@ public:
    * @param make_tuple_of_matchers The matching handler
    */
   Behavior(std::shared_ptr<detail::IMakeTupleOfMatchers<Args...>> make_tuple_of_matchers);
+  /**
+   * @param make_tuple_of_matchers The matching handler
+   * @param unsatisfied Counter of the unsatisfied behaviors of a queue
+   * @param arena The arena for return values and signals
+   *
+   * `this` adds one to `unsatisfied` while it is not exhausted (see
+   * `is_exhausted`). The `unsatisfied` and `arena` parameters are used
+   * by `BehaviorQueue` and should not be used by a consumer; copies of
+   * `this` don't share `unsatisfied`.
+   */
+  Behavior(
+      std::shared_ptr<detail::IMakeTupleOfMatchers<Args...>> make_tuple_of_matchers,
+      std::shared_ptr<detail::Counter> unsatisfied,
+      std::shared_ptr<detail::Arena> arena
+    );
+  // Copies take a snapshot of the number of productions.
+  Behavior(const Behavior&);
+  Behavior& operator=(const Behavior&);
 
   /**
    * Expect _any_ input.
@@ -124,6 +148,23 @@ public:
    */
   template<typename... Deriveds> Behavior& expects(detail::Expect<Args>... args);
 
+  /**
+   * Expect input matching the static matchers `matchers...`.
+   *
+   * @param matchers... The static matchers (`eq`, `almost` or `any`),
+   *   one for each parameter
+   *
+   * The matchers are stored by value, so matching doesn't require a
+   * virtual call per argument. Use `expects` for runtime-polymorphic
+   * `IMatcher` objects.
+   */
+  template<typename... Matchers>
+  std::enable_if_t<
+      (sizeof...(Matchers) == sizeof...(Args))
+        and (detail::is_static_matcher_v<Matchers> and ...),
+      Behavior&
+    > expects_static(Matchers&&... matchers);
+
   /**
    * Configure `this` to return `result` on productions.
    */
@@ -184,6 +225,13 @@ public:
    */
   bool is_exhausted() const;
 
+  /**
+   * Check if `this` is a _stub_: It persists, matches any input and
+   * produces a return value (unless `ReturnType` is `void`), but no
+   * exception.
+   */
+  bool is_stub() const;
+
   /**
    * Match `args...` against the stored matchers.
    *
@@ -192,23 +240,62 @@ public:
    */
   bool match(const Args&... args) const;
 
+  /**
+   * Return the hash of the expected input if all stored matchers are
+   * `Equal<Args>` objects or `eq` static matchers of types that are
+   * hashable by equality (see `detail::is_hashable_by_equality_v`).
+   * Otherwise, return `std::nullopt`.
+   *
+   * If the hash is defined, then `match(args...)` implies
+   * `detail::hashAll(args...) == *hash()`.
+   */
+  std::optional<std::size_t> hash() const;
+
   /**
    * Produce a return value, Qt signal emit or exception pointer.
    *
-   * The default production is `nullptr` (representing no value).
+   * The default production is `nullptr` (representing no value). The
+   * returned pointers point into `this`.
+   */
+  std::variant<detail::ResultRef<Class, ReturnType>, std::exception_ptr> produce();
+
+  /**
+   * Count a production, if `this` is persistent.
+   *
+   * Returns `false` if `this` no longer persists. The number of
+   * productions is an atomic counter, so `claim` may be called from
+   * several threads; if two threads race for the last production,
+   * exactly one of them succeeds. Persistent behaviors which have
+   * reached their maximum number of productions are not written to.
    */
-  std::variant<Result, std::exception_ptr> produce();
+  bool claim();
+
+  /**
+   * Return the production without counting it (see `produce`).
+   */
+  std::variant<detail::ResultRef<Class, ReturnType>, std::exception_ptr> production() const;
+
+  /**
+   * Return the result without counting it. Ignores the exception.
+   */
+  detail::ResultRef<Class, ReturnType> result() const;
 
 private:
   std::optional<std::tuple<std::shared_ptr<IMatcher<Args>>...>> expect_{};
+  detail::StaticMatch<Args...> static_expect_{};
   Result result_{};
   std::exception_ptr exception_{};
   unsigned int times_min_ = 1;
   unsigned int times_max_ = 1;
-  unsigned int num_calls_ = 0;  // Number of productions made.
+  std::atomic<unsigned int> num_calls_{0};  // Number of productions made.
   bool persists_ = false;
   std::shared_ptr<detail::IMakeTupleOfMatchers<Args...>> make_tuple_of_matchers_{};
   detail::MatchPack<std::tuple<Args...>> match_pack_{};
+  std::shared_ptr<detail::Counter> unsatisfied_{};
+  std::shared_ptr<detail::Arena> arena_{};  /**> Arena for `result_`; `nullptr` for the heap */
+
+  // Update `unsatisfied_` after a configuration change.
+  void account(bool was_exhausted);
 };
 
 } // namespace
@@ -17,7 +17,10 @@
 */
 
 #include <DrMock/utility/detail/TypeInfo.h>
+#include <DrMock/mock/detail/Backoff.h>
+#include <DrMock/mock/detail/Hash.h>
 #include <DrMock/mock/detail/MakeTupleOfMatchers.h>
+#include <DrMock/mock/Equal.h>
 #include <DrMock/mock/Signal.h>
 
 namespace drmock {
@@ -36,12 +39,62 @@ Behavior<Class, ReturnType, Args...>::Behavior(
   make_tuple_of_matchers_{std::move(make_tuple_of_matchers)}
 {}
 
+template<typename Class, typename ReturnType, typename... Args>
+Behavior<Class, ReturnType, Args...>::Behavior(
+    std::shared_ptr<detail::IMakeTupleOfMatchers<Args...>> make_tuple_of_matchers,
+    std::shared_ptr<detail::Counter> unsatisfied,
+    std::shared_ptr<detail::Arena> arena
+  )
+:
+  make_tuple_of_matchers_{std::move(make_tuple_of_matchers)},
+  unsatisfied_{std::move(unsatisfied)},
+  arena_{std::move(arena)}
+{
+  account(true);
+}
+
+template<typename Class, typename ReturnType, typename... Args>
+Behavior<Class, ReturnType, Args...>::Behavior(const Behavior& other)
+:
+  expect_{other.expect_},
+  static_expect_{other.static_expect_},
+  result_{other.result_},
+  exception_{other.exception_},
+  times_min_{other.times_min_},
+  times_max_{other.times_max_},
+  num_calls_{other.num_calls_.load(std::memory_order_relaxed)},
+  persists_{other.persists_},
+  make_tuple_of_matchers_{other.make_tuple_of_matchers_},
+  match_pack_{other.match_pack_},
+  arena_{other.arena_}
+{}
+
+template<typename Class, typename ReturnType, typename... Args>
+Behavior<Class, ReturnType, Args...>&
+Behavior<Class, ReturnType, Args...>::operator=(const Behavior& other)
+{
+  bool was_exhausted = is_exhausted();
+  expect_ = other.expect_;
+  static_expect_ = other.static_expect_;
+  result_ = other.result_;
+  exception_ = other.exception_;
+  times_min_ = other.times_min_;
+  times_max_ = other.times_max_;
+  num_calls_.store(other.num_calls_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+  persists_ = other.persists_;
+  make_tuple_of_matchers_ = other.make_tuple_of_matchers_;
+  match_pack_ = other.match_pack_;
+  arena_ = other.arena_;
+  account(was_exhausted);
+  return *this;
+}
+
 template<typename Class, typename ReturnType, typename... Args>
 template<typename T>
 std::enable_if_t<(std::tuple_size_v<T> > 0), Behavior<Class, ReturnType, Args...>&>
 Behavior<Class, ReturnType, Args...>::expects()
 {
-  if (expect_.has_value())
+  if (expect_.has_value() or static_expect_)
   {
     throw std::runtime_error{
         "Cannot revert Behavior object already configured for specific expect to except-all."
@@ -56,7 +109,7 @@ template<typename Class, typename ReturnType, typename... Args>
 Behavior<Class, ReturnType, Args...>&
 Behavior<Class, ReturnType, Args...>::expects(detail::Expect<Args>... args)
 {
-  if (expect_.has_value())
+  if (expect_.has_value() or static_expect_)
   {
     throw std::runtime_error{
         "Behavior object already configured. Please check your mock object configuration."
@@ -66,6 +119,25 @@ Behavior<Class, ReturnType, Args...>::expects(detail::Expect<Args>... args)
   return *this;
 }
 
+template<typename Class, typename ReturnType, typename... Args>
+template<typename... Matchers>
+std::enable_if_t<
+    (sizeof...(Matchers) == sizeof...(Args))
+      and (detail::is_static_matcher_v<Matchers> and ...),
+    Behavior<Class, ReturnType, Args...>&
+  >
+Behavior<Class, ReturnType, Args...>::expects_static(Matchers&&... matchers)
+{
+  if (expect_.has_value() or static_expect_)
+  {
+    throw std::runtime_error{
+        "Behavior object already configured. Please check your mock object configuration."
+      };
+  }
+  static_expect_ = detail::makeStaticMatch<Args...>(std::forward<Matchers>(matchers)...);
+  return *this;
+}
+
 template<typename Class, typename ReturnType, typename...Args>
 template<typename... Ts>
 Behavior<Class, ReturnType, Args...>&
@@ -86,7 +158,7 @@ Behavior<Class, ReturnType, Args...>::returns(T&& result)
         "Behavior object already configured. Please check your mock object configuration."
       };
   }
-  result_.first = std::make_shared<std::decay_t<ReturnType>>(std::forward<T>(result));
+  result_.first = detail::allocateShared<std::decay_t<ReturnType>>(arena_, std::forward<T>(result));
   return *this;
 }
 
@@ -119,7 +191,8 @@ Behavior<Class, ReturnType, Args...>::emits(
         "Behavior object already configured. Please check your mock object configuration."
       };
   }
-  result_.second = std::make_shared<Signal<Class, SignalArgs...>>(
+  result_.second = detail::allocateShared<Signal<Class, SignalArgs...>>(
+      arena_,
       signal,
       std::forward<SignalArgs>(args)...
     );
@@ -155,8 +228,10 @@ Behavior<Class, ReturnType, Args...>::times(
         " calls. Please check your mock object configuration."
       };
   }
+  bool was_exhausted = is_exhausted();
   times_min_ = times_min;
   times_max_ = times_max;
+  account(was_exhausted);
   return *this;
 }
 
@@ -171,7 +246,9 @@ Behavior<Class, ReturnType, Args...>::persists()
         or std::is_same_v<ReturnType, void>,
       "result type must be reference, pointer or copy-constructible to set persists()"
     );
+  bool was_exhausted = is_exhausted();
   persists_ = true;
+  account(was_exhausted);
   return *this;
 }
 
@@ -179,14 +256,26 @@ template<typename Class, typename ReturnType, typename... Args>
 bool
 Behavior<Class, ReturnType, Args...>::is_persistent() const
 {
-  return persists_ or (num_calls_ < times_max_);
+  return persists_ or (num_calls_.load(std::memory_order_relaxed) < times_max_);
 }
 
 template<typename Class, typename ReturnType, typename... Args>
 bool
 Behavior<Class, ReturnType, Args...>::is_exhausted() const
 {
-  return persists_ or ((times_min_ <= num_calls_) and (num_calls_ <= times_max_));
+  auto num_calls = num_calls_.load(std::memory_order_relaxed);
+  return persists_ or ((times_min_ <= num_calls) and (num_calls <= times_max_));
+}
+
+template<typename Class, typename ReturnType, typename... Args>
+bool
+Behavior<Class, ReturnType, Args...>::is_stub() const
+{
+  return persists_
+      and not expect_
+      and not static_expect_
+      and not exception_
+      and (std::is_same_v<ReturnType, void> or result_.first);
 }
 
 template<typename Class, typename ReturnType, typename... Args>
@@ -204,7 +293,7 @@ Behavior<Class, ReturnType, Args...>::polymorphic()
   make_tuple_of_matchers_ = std::make_shared<detail::MakeTupleOfMatchers<
       std::tuple<Args...>,
       std::tuple<Deriveds...>
-    >>();
+    >>(arena_);
   return *this;
 }
 
@@ -212,7 +301,11 @@ template<typename Class, typename ReturnType, typename... Args>
 bool
 Behavior<Class, ReturnType, Args...>::match(const Args&... args) const
 {
-  if (expect_)
+  if (static_expect_)
+  {
+    return static_expect_(args...);
+  }
+  else if (expect_)
   {
     return match_pack_(*expect_, args...);
   }
@@ -223,24 +316,101 @@ Behavior<Class, ReturnType, Args...>::match(const Args&... args) const
 }
 
 template<typename Class, typename ReturnType, typename... Args>
-std::variant<
-    typename Behavior<Class, ReturnType, Args...>::Result,
-    std::exception_ptr
-  >
+std::optional<std::size_t>
+Behavior<Class, ReturnType, Args...>::hash() const
+{
+  if (static_expect_)
+  {
+    return static_expect_.hash();
+  }
+  if constexpr ((detail::is_hashable_by_equality_v<Args> and ...))
+  {
+    if (not expect_)
+    {
+      return std::nullopt;
+    }
+    return std::apply(
+        [] (const std::shared_ptr<IMatcher<Args>>&... matchers) -> std::optional<std::size_t> {
+          // Note: `dynamic_cast` to `Equal<Args, Args>` rejects custom
+          // matchers and polymorphic `Equal<Args, Deriveds>`.
+          auto equals = std::make_tuple(dynamic_cast<const Equal<Args>*>(matchers.get())...);
+          return std::apply(
+              [] (auto... ptrs) -> std::optional<std::size_t> {
+                if (not (ptrs and ...))
+                {
+                  return std::nullopt;
+                }
+                return detail::hashAll(ptrs->expected()...);
+              },
+              equals
+            );
+        },
+        *expect_
+      );
+  }
+  else
+  {
+    return std::nullopt;
+  }
+}
+
+template<typename Class, typename ReturnType, typename... Args>
+std::variant<detail::ResultRef<Class, ReturnType>, std::exception_ptr>
 Behavior<Class, ReturnType, Args...>::produce()
 {
-  if (num_calls_ < times_max_)
+  claim();
+  return production();
+}
+
+template<typename Class, typename ReturnType, typename... Args>
+bool
+Behavior<Class, ReturnType, Args...>::claim()
+{
+  detail::Backoff backoff{};
+  auto num_calls = num_calls_.load(std::memory_order_relaxed);
+  while (num_calls < times_max_)
   {
-    ++num_calls_;
+    if (num_calls_.compare_exchange_weak(num_calls, num_calls + 1, std::memory_order_relaxed))
+    {
+      if (unsatisfied_ and not persists_ and num_calls + 1 == times_min_)
+      {
+        unsatisfied_->add(-1);
+      }
+      return true;
+    }
+    backoff();
   }
+  return persists_;
+}
 
+template<typename Class, typename ReturnType, typename... Args>
+std::variant<detail::ResultRef<Class, ReturnType>, std::exception_ptr>
+Behavior<Class, ReturnType, Args...>::production() const
+{
   if (exception_)
   {
     return exception_;
   }
   else
   {
-    return result_;
+    return result();
+  }
+}
+
+template<typename Class, typename ReturnType, typename... Args>
+detail::ResultRef<Class, ReturnType>
+Behavior<Class, ReturnType, Args...>::result() const
+{
+  return {result_.first.get(), result_.second.get()};
+}
+
+template<typename Class, typename ReturnType, typename... Args>
+void
+Behavior<Class, ReturnType, Args...>::account(bool was_exhausted)
+{
+  if (unsatisfied_ and was_exhausted != is_exhausted())
+  {
+    unsatisfied_->add(was_exhausted ? 1 : -1);
   }
 }
 
@@ -19,11 +19,20 @@
 #ifndef DRMOCK_SRC_DRMOCK_MOCK_BEHAVIORSTACK_H
 #define DRMOCK_SRC_DRMOCK_MOCK_BEHAVIORSTACK_H
 
+#include <atomic>
+#include <cstddef>
+#include <deque>
 #include <exception>
+#include <limits>
+#include <list>
 #include <memory>
+#include <mutex>
+#include <unordered_map>
 #include <variant>
 #include <vector>
 
+#include <DrMock/mock/detail/Arena.h>
+#include <DrMock/mock/detail/Counter.h>
 #include <DrMock/mock/detail/IMakeTupleOfMatchers.h>
 #include <DrMock/mock/AbstractBehavior.h>
 #include <DrMock/mock/Behavior.h>
@@ -51,17 +60,21 @@ namespace drmock {
 template<typename Class, typename ReturnType, typename... Args>
 class BehaviorQueue final : public AbstractBehavior<Class, ReturnType, Args...>
 {
-  using Result = std::pair<
-      std::shared_ptr<std::decay_t<ReturnType>>,
-      std::shared_ptr<AbstractSignal<Class>>
-    >;
-
 public:
   BehaviorQueue();
   /**
    * @params make_tuple_of_matchers The tuple handler
    */
   BehaviorQueue(std::shared_ptr<detail::IMakeTupleOfMatchers<Args...>> make_tuple_of_matchers);
+  /**
+   * @params make_tuple_of_matchers The tuple handler
+   * @params arena The arena for the behaviors and their results
+   *   (`nullptr` for the heap)
+   */
+  BehaviorQueue(
+      std::shared_ptr<detail::IMakeTupleOfMatchers<Args...>> make_tuple_of_matchers,
+      std::shared_ptr<detail::Arena> arena
+    );
 
   /**
    * Push a new `Behavior` onto the queue and return a reference.
@@ -78,6 +91,20 @@ public:
    */
   void enforce_order(bool);
 
+  /**
+   * Allow `call` to be called from several threads at once.
+   *
+   * If the order is enforced, a concurrent `call` is lock-free: The
+   * front of the queue is an atomic index which is advanced past
+   * exhausted behaviors with compare-and-swap, and productions are
+   * counted atomically (see `Behavior::claim`). Calls that match a
+   * persistent behavior at the front of the queue only read shared
+   * state. Otherwise, the search is guarded by a mutex.
+   *
+   * The queue must not be configured while calls are in flight.
+   */
+  void concurrent(bool);
+
   /**
    * Set polymorphic type of the matching handler of all future
    * behaviors _and_ all behaviors already enqueued.
@@ -98,25 +125,98 @@ public:
    * 
    * If `enforce_order` is set to `false`, then the entire queue is
    * instead searched from front to back for a matching element.
+   *
+   * Elements that no longer persist are skipped and dropped from the
+   * queue as they are encountered, so a run of calls through a queue
+   * of one-shot behaviors takes linear time.
+   *
+   * If `enforce_order` is set to `false`, elements whose expected input
+   * is hashable (see `Behavior::hash`) are looked up by the hash of
+   * `args...`. Only the remaining elements are searched linearly.
+   * Elements are sorted into the index on the first call after they
+   * were pushed, so they must be configured by then.
    */
-  virtual std::variant<
-      std::monostate,
-      Result,
-      std::exception_ptr
-    > call(const Args&... args) override;
+  virtual detail::Production<Class, ReturnType> call(const Args&... args) override;
 
   /**
    * Check if all elements of the container are exhausted.
+   *
+   * The number of elements which are not exhausted is kept up to date
+   * by the elements, so this takes constant time.
    */
   bool is_exhausted() const;
 
+  /**
+   * Forward the number of elements which are not exhausted to `counter`
+   * (see `detail::Counter`), or stop forwarding if `counter` is
+   * `nullptr`. Used by `Method`.
+   */
+  void track(std::shared_ptr<detail::Counter> counter);
+
+  /**
+   * Return the first persistent element of the queue if it is a stub
+   * (see `Behavior::is_stub`), otherwise `nullptr`.
+   *
+   * Exhausted elements before the stub are skipped. A stub at the front
+   * of the queue handles every call, regardless of `enforce_order`. The caller may therefore skip `call` and use the
+   * result of the stub directly.
+   */
+  Behavior<Class, ReturnType, Args...>* stub();
+
+  /**
+   * Remove all behaviors from the queue and allocate the future ones
+   * from `arena`, so that the old arena may be released.
+   *
+   * @param make_tuple_of_matchers The tuple handler for future
+   *   behaviors
+   * @param arena The arena for future behaviors (`nullptr` for the
+   *   heap)
+   *
+   * References to the removed behaviors are invalidated. The settings
+   * of `enforce_order` and `concurrent` are kept. Must not be called
+   * while calls are in flight.
+   */
+  void clear(
+      std::shared_ptr<detail::IMakeTupleOfMatchers<Args...>> make_tuple_of_matchers,
+      std::shared_ptr<detail::Arena> arena
+    );
+
 private:
+  static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+  // Return the index of the behavior that matches `args...` or `npos`.
+  std::size_t findOrdered(const Args&... args);
+  std::size_t findUnordered(const Args&... args);
+  // Return the index of the behavior that matches `args...` and count
+  // the production, or return `npos`. Thread-safe.
+  std::size_t claimOrdered(const Args&... args);
+  std::size_t claimUnordered(const Args&... args);
+  // Sort the behaviors pushed since the last call into `index_` or
+  // `unindexed_`.
+  void indexNewBehaviors();
+
   std::shared_ptr<detail::IMakeTupleOfMatchers<Args...>> make_tuple_of_matchers_{};  /**> The tuple handler object */
-  // The queue is implemented as `std::vector`. Exhausted behaviors
-  // remain in the vector. The "first" element of the queue is the first
+  std::shared_ptr<detail::Arena> arena_{};  /**> The arena for behaviors; `nullptr` for the heap */
+  // The queue is implemented as `std::deque`. Exhausted behaviors
+  // remain in the deque. The "first" element of the queue is the first
   // persistent element.
-  std::vector<Behavior<Class, ReturnType, Args...>> behaviors_{};  /**> The queue of behaviors */
+  std::deque<
+      Behavior<Class, ReturnType, Args...>,
+      detail::ArenaAllocator<Behavior<Class, ReturnType, Args...>>
+    > behaviors_;  /**> The queue of behaviors */
+  std::shared_ptr<detail::Counter> unsatisfied_{std::make_shared<detail::Counter>()};  /**> Number of behaviors which are not exhausted */
+  // Indices of the elements of `behaviors_` which may still persist,
+  // in order. Elements which no longer persist are removed lazily by
+  // `call`. If the order is enforced, these are the elements from
+  // `head_` on; otherwise, they are kept in `index_` (hash of the
+  // expected input -> indices in order) and `unindexed_`.
+  std::unordered_map<std::size_t, std::deque<std::size_t>> index_{};
+  std::list<std::size_t> unindexed_{};
+  std::size_t num_indexed_ = 0;  /**> Number of behaviors sorted into `index_` or `unindexed_` */
   bool enforce_order_ = true;  /**> Expect the behaviors of the queue to occur in order */
+  bool concurrent_ = false;  /**> Allow concurrent calls */
+  std::atomic<std::size_t> head_{0};  /**> Lower bound for the first persistent element; used if the order is enforced */
+  std::mutex mtx_{};  /**> Guards `findUnordered` in `claimUnordered` */
 };
 
 } // namespace drmock
@@ -16,8 +16,6 @@
  * along with DrMock.  If not, see <https://www.gnu.org/licenses/>.
 */
 
-#include <algorithm>
-
 namespace drmock {
 
 template<typename Class, typename ReturnType, typename... Args>
@@ -31,14 +29,25 @@ BehaviorQueue<Class, ReturnType, Args...>::BehaviorQueue(
     std::shared_ptr<detail::IMakeTupleOfMatchers<Args...>> make_tuple_of_matchers
   )
 :
-  make_tuple_of_matchers_{std::move(make_tuple_of_matchers)}
+  BehaviorQueue{std::move(make_tuple_of_matchers), nullptr}
+{}
+
+template<typename Class, typename ReturnType, typename... Args>
+BehaviorQueue<Class, ReturnType, Args...>::BehaviorQueue(
+    std::shared_ptr<detail::IMakeTupleOfMatchers<Args...>> make_tuple_of_matchers,
+    std::shared_ptr<detail::Arena> arena
+  )
+:
+  make_tuple_of_matchers_{std::move(make_tuple_of_matchers)},
+  arena_{std::move(arena)},
+  behaviors_{detail::ArenaAllocator<Behavior<Class, ReturnType, Args...>>{arena_}}
 {}
 
 template<typename Class, typename ReturnType, typename... Args>
 Behavior<Class, ReturnType, Args...>&
 BehaviorQueue<Class, ReturnType, Args...>::push()
 {
-  behaviors_.emplace_back(make_tuple_of_matchers_);
+  behaviors_.emplace_back(make_tuple_of_matchers_, unsatisfied_, arena_);
   return behaviors_.back();
 }
 
@@ -56,6 +65,13 @@ BehaviorQueue<Class, ReturnType, Args...>::enforce_order(bool value)
   enforce_order_ = value;
 }
 
+template<typename Class, typename ReturnType, typename... Args>
+void
+BehaviorQueue<Class, ReturnType, Args...>::concurrent(bool value)
+{
+  concurrent_ = value;
+}
+
 template<typename Class, typename ReturnType, typename... Args>
 template<typename... Deriveds>
 void
@@ -64,7 +80,7 @@ BehaviorQueue<Class, ReturnType, Args...>::polymorphic()
   make_tuple_of_matchers_ = std::make_shared<detail::MakeTupleOfMatchers<
       std::tuple<Args...>,
       std::tuple<Deriveds...>
-    >>();
+    >>(arena_);
   for (auto& b : behaviors_)
   {
     b.template polymorphic<Deriveds...>();
@@ -72,53 +88,33 @@ BehaviorQueue<Class, ReturnType, Args...>::polymorphic()
 }
 
 template<typename Class, typename ReturnType, typename... Args>
-std::variant<
-    std::monostate,
-    std::pair<
-        std::shared_ptr<typename std::decay<ReturnType>::type>,
-        std::shared_ptr<AbstractSignal<Class>>
-      >,
-    std::exception_ptr
-  >
+detail::Production<Class, ReturnType>
 BehaviorQueue<Class, ReturnType, Args...>::call(const Args&... args)
 {
-  auto match = behaviors_.end();
-  auto begin = std::find_if(
-      behaviors_.begin(), behaviors_.end(),
-      [] (const auto& behavior) { return behavior.is_persistent(); }
-    );
-  if (begin != behaviors_.end())
+  std::size_t match = npos;
+  if (concurrent_)
   {
-    if (enforce_order_)
-    {
-      if (begin->match(args...))
-      {
-        match = begin;
-      }
-    }
-    else
+    match = enforce_order_ ? claimOrdered(args...) : claimUnordered(args...);
+  }
+  else
+  {
+    match = enforce_order_ ? findOrdered(args...) : findUnordered(args...);
+    if (match != npos)
     {
-      match = std::find_if(
-          begin, behaviors_.end(),
-          [&args...] (const auto& behavior) { return behavior.match(args...); }
-        );
+      behaviors_[match].claim();
     }
   }
 
-  if (match != behaviors_.end())
+  if (match != npos)
   {
-    auto result = match->produce();
-
+    auto result = behaviors_[match].production();
     if (std::holds_alternative<std::exception_ptr>(result))
     {
       return std::get<std::exception_ptr>(result);
     }
     else
     {
-      return std::get<std::pair<
-              std::shared_ptr<std::decay_t<ReturnType>>,
-              std::shared_ptr<AbstractSignal<Class>>
-        >>(result);
+      return std::get<detail::ResultRef<Class, ReturnType>>(result);
     }
   }
   else
@@ -127,14 +123,193 @@ BehaviorQueue<Class, ReturnType, Args...>::call(const Args&... args)
   }
 }
 
+template<typename Class, typename ReturnType, typename... Args>
+std::size_t
+BehaviorQueue<Class, ReturnType, Args...>::findOrdered(const Args&... args)
+{
+  auto head = head_.load(std::memory_order_relaxed);
+  while (head < behaviors_.size() and not behaviors_[head].is_persistent())
+  {
+    ++head;
+  }
+  head_.store(head, std::memory_order_relaxed);
+  if (head < behaviors_.size() and behaviors_[head].match(args...))
+  {
+    return head;
+  }
+  return npos;
+}
+
+template<typename Class, typename ReturnType, typename... Args>
+std::size_t
+BehaviorQueue<Class, ReturnType, Args...>::findUnordered(const Args&... args)
+{
+  indexNewBehaviors();
+
+  // Find the first matching behavior with the same hash. (The bucket
+  // may contain behaviors with a different input due to collisions.)
+  std::size_t match = npos;
+  if constexpr ((detail::is_hashable_by_equality_v<Args> and ...))
+  {
+    auto it = index_.find(detail::hashAll(args...));
+    if (it != index_.end())
+    {
+      auto& bucket = it->second;
+      while (not bucket.empty() and not behaviors_[bucket.front()].is_persistent())
+      {
+        bucket.pop_front();
+      }
+      for (auto i : bucket)
+      {
+        const auto& behavior = behaviors_[i];
+        if (behavior.is_persistent() and behavior.match(args...))
+        {
+          match = i;
+          break;
+        }
+      }
+      if (bucket.empty())
+      {
+        index_.erase(it);
+      }
+    }
+  }
+
+  // Unindexed behaviors pushed before `match` take precedence.
+  for (auto it = unindexed_.begin(); it != unindexed_.end() and *it < match; )
+  {
+    const auto& behavior = behaviors_[*it];
+    if (not behavior.is_persistent())
+    {
+      it = unindexed_.erase(it);
+    }
+    else if (behavior.match(args...))
+    {
+      return *it;
+    }
+    else
+    {
+      ++it;
+    }
+  }
+  return match;
+}
+
+template<typename Class, typename ReturnType, typename... Args>
+std::size_t
+BehaviorQueue<Class, ReturnType, Args...>::claimOrdered(const Args&... args)
+{
+  auto head = head_.load(std::memory_order_acquire);
+  while (head < behaviors_.size())
+  {
+    auto& behavior = behaviors_[head];
+    if (behavior.is_persistent())
+    {
+      if (not behavior.match(args...))
+      {
+        return npos;
+      }
+      if (behavior.claim())
+      {
+        return head;
+      }
+      // Another thread made the last production; retry with the next
+      // behavior.
+    }
+    else if (head_.compare_exchange_weak(head, head + 1, std::memory_order_acq_rel))
+    {
+      ++head;
+    }
+  }
+  return npos;
+}
+
+template<typename Class, typename ReturnType, typename... Args>
+std::size_t
+BehaviorQueue<Class, ReturnType, Args...>::claimUnordered(const Args&... args)
+{
+  std::lock_guard<std::mutex> lck{mtx_};
+  auto match = findUnordered(args...);
+  if (match != npos)
+  {
+    behaviors_[match].claim();
+  }
+  return match;
+}
+
+template<typename Class, typename ReturnType, typename... Args>
+void
+BehaviorQueue<Class, ReturnType, Args...>::indexNewBehaviors()
+{
+  for (; num_indexed_ < behaviors_.size(); ++num_indexed_)
+  {
+    auto hash = behaviors_[num_indexed_].hash();
+    if (hash)
+    {
+      index_[*hash].push_back(num_indexed_);
+    }
+    else
+    {
+      unindexed_.push_back(num_indexed_);
+    }
+  }
+}
+
 template<typename Class, typename ReturnType, typename... Args>
 bool
 BehaviorQueue<Class, ReturnType, Args...>::is_exhausted() const
 {
-  return std::all_of(
-      behaviors_.begin(), behaviors_.end(),
-      [](const auto& x) { return x.is_exhausted(); }
-    );
+  return unsatisfied_->get() == 0;
+}
+
+template<typename Class, typename ReturnType, typename... Args>
+void
+BehaviorQueue<Class, ReturnType, Args...>::track(std::shared_ptr<detail::Counter> counter)
+{
+  unsatisfied_->parent(std::move(counter));
+}
+
+template<typename Class, typename ReturnType, typename... Args>
+Behavior<Class, ReturnType, Args...>*
+BehaviorQueue<Class, ReturnType, Args...>::stub()
+{
+  // Skip the behaviors that no longer persist, see `findOrdered`. A
+  // concurrent `claimOrdered` may advance `head_` as well, so only
+  // advance it if it wasn't moved in the meantime.
+  auto old_head = head_.load(std::memory_order_acquire);
+  auto head = old_head;
+  while (head < behaviors_.size() and not behaviors_[head].is_persistent())
+  {
+    ++head;
+  }
+  if (head != old_head)
+  {
+    head_.compare_exchange_strong(old_head, head, std::memory_order_acq_rel);
+  }
+  if (head == behaviors_.size() or not behaviors_[head].is_stub())
+  {
+    return nullptr;
+  }
+  return &behaviors_[head];
+}
+
+template<typename Class, typename ReturnType, typename... Args>
+void
+BehaviorQueue<Class, ReturnType, Args...>::clear(
+    std::shared_ptr<detail::IMakeTupleOfMatchers<Args...>> make_tuple_of_matchers,
+    std::shared_ptr<detail::Arena> arena
+  )
+{
+  make_tuple_of_matchers_ = std::move(make_tuple_of_matchers);
+  arena_ = std::move(arena);
+  // The allocator is propagated, so the new deque takes its memory
+  // from the new arena.
+  behaviors_ = decltype(behaviors_){detail::ArenaAllocator<Behavior<Class, ReturnType, Args...>>{arena_}};
+  unsatisfied_->add(-unsatisfied_->get());
+  index_.clear();
+  unindexed_.clear();
+  num_indexed_ = 0;
+  head_.store(0, std::memory_order_relaxed);
 }
 
 } // namespace drmock
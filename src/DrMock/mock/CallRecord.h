@@ -0,0 +1,50 @@
+/* Copyright 2021 Ole Kliemann, Malte Kliemann
+ *
+ * This file is part of DrMock.
+ *
+ * DrMock is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DrMock is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DrMock.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef DRMOCK_SRC_DRMOCK_MOCK_CALLRECORD_H
+#define DRMOCK_SRC_DRMOCK_MOCK_CALLRECORD_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace drmock {
+
+/**
+ * A call of a `Method` recorded by `Method::record`.
+ *
+ * The sequence numbers of all recorded calls are unique and increase
+ * across all methods (and threads) in the order in which the calls
+ * occured.
+ */
+struct CallRecord
+{
+  std::string method;  /**> The name of the method */
+  std::uint64_t sequence;  /**> The global sequence number of the call */
+  std::chrono::steady_clock::time_point time;  /**> The time of the call */
+  /**
+   * The printed arguments of the call (see `Method::error_msgs`). Empty
+   * if the arguments are not copy-constructible and were therefore not
+   * recorded.
+   */
+  std::vector<std::string> args;
+};
+
+} // namespace drmock
+
+#endif /* DRMOCK_SRC_DRMOCK_MOCK_CALLRECORD_H */
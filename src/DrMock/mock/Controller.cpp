@@ -19,9 +19,11 @@
 #include "Controller.h"
 
 #include <algorithm>
+#include <iterator>
 
 #include <DrMock/mock/IMethod.h>
 #include <DrMock/mock/StateObject.h>
+#include <DrMock/mock/detail/Arena.h>
 
 namespace drmock {
 
@@ -37,13 +39,21 @@ Controller::Controller(
 :
   methods_{std::move(methods)},
   state_object_{std::move(state_object)}
-{}
+{
+  for (const auto& method : methods_)
+  {
+    if (not method->track(unverified_))
+    {
+      untracked_.push_back(method);
+    }
+  }
+}
 
 bool
 Controller::verify() const
 {
-  return std::all_of(
-      methods_.begin(), methods_.end(),
+  return (unverified_->get() == 0) and std::all_of(
+      untracked_.begin(), untracked_.end(),
       [] (const auto& method) { return method->verify(); }
     );
 }
@@ -64,21 +74,75 @@ std::string
 Controller::makeFormattedErrorString() const
 {
   std::string result = "";
-  for (std::size_t i = 0; i < methods_.size(); ++i)
+  for (const auto& method : methods_)
   {
-    auto err = methods_[i]->makeFormattedErrorString();
+    if (method->verify())
+    {
+      continue;
+    }
+    auto err = method->makeFormattedErrorString();
     if (err == "")
     {
       continue;
     }
-    result += err;
-
-    if (i != methods_.size() - 1)
+    if (result != "")
     {
       result += "\n";
     }
+    result += err;
+  }
+  return result;
+}
+
+std::vector<CallRecord>
+Controller::calls() const
+{
+  std::vector<CallRecord> result{};
+  for (const auto& method : methods_)
+  {
+    auto records = method->makeCallRecords();
+    std::move(records.begin(), records.end(), std::back_inserter(result));
   }
+  std::sort(
+      result.begin(), result.end(),
+      [] (const auto& lhs, const auto& rhs) { return lhs.sequence < rhs.sequence; }
+    );
   return result;
 }
 
+std::vector<CallRecord>
+Controller::calls(const std::string& method) const
+{
+  auto result = calls();
+  result.erase(
+      std::remove_if(
+          result.begin(), result.end(),
+          [&method] (const auto& record) { return record.method != method; }
+        ),
+      result.end()
+    );
+  return result;
+}
+
+void
+Controller::clearQueues()
+{
+  // Renew the arena once, so that all methods of the mock share the new
+  // one.
+  std::shared_ptr<detail::Arena> arena{};
+  if (state_object_)
+  {
+    state_object_->renewArena();
+    arena = state_object_->arena();
+  }
+  else
+  {
+    arena = std::make_shared<detail::Arena>();
+  }
+  for (const auto& method : methods_)
+  {
+    method->clearQueue(arena);
+  }
+}
+
 } // namespace drmock
@@ -23,6 +23,9 @@
 #include <string>
 #include <vector>
 
+#include <DrMock/mock/CallRecord.h>
+#include <DrMock/mock/detail/Counter.h>
+
 namespace drmock {
 
 class IMethod;
@@ -51,6 +54,10 @@ public:
 
   /**
    * Verify all methods in the collection.
+   *
+   * Methods which support tracking (see `IMethod::track`) report
+   * changes of their state to the controller, so this takes constant
+   * time for them.
    */
   bool verify() const;
 
@@ -64,14 +71,38 @@ public:
   bool verifyState(const std::string& slot, const std::string& state) const;
 
   /**
-   * Return the concatenation of the error strings of the method
-   * collection.
+   * Return the concatenation of the error strings of the methods of the
+   * collection which fail to verify.
    */
   std::string makeFormattedErrorString() const;
 
+  /**
+   * Return the recorded calls of all methods of the collection (see
+   * `Method::record`), ordered by their sequence number.
+   */
+  std::vector<CallRecord> calls() const;
+
+  /**
+   * Return the recorded calls of the methods named `method`, ordered by
+   * their sequence number.
+   */
+  std::vector<CallRecord> calls(const std::string& method) const;
+
+  /**
+   * Remove all behaviors from the behavior queues of the methods of the
+   * collection (see `Method::clearQueue`).
+   *
+   * Once the queues of all methods are cleared, the memory taken by
+   * their behaviors is released. Must not be called while calls are in
+   * flight.
+   */
+  void clearQueues();
+
 private:
   std::vector<std::shared_ptr<IMethod>> methods_{};  /**> The method collection */
   std::shared_ptr<StateObject> state_object_{};  /**> The shared state object */
+  std::shared_ptr<detail::Counter> unverified_{std::make_shared<detail::Counter>()};  /**> Sum of the counters of the tracked methods */
+  std::vector<std::shared_ptr<IMethod>> untracked_{};  /**> Methods which don't support tracking */
 };
 
 } // namespace drmock
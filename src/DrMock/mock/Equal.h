@@ -76,6 +76,15 @@ public:
     return is_equal(expected_, actual);
   }
 
+  /**
+   * Return the element to match against.
+   */
+  const Base&
+  expected() const
+  {
+    return expected_;
+  }
+
 private:
   Base expected_;  /**< The element to match against */
 };
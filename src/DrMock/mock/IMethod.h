@@ -19,10 +19,21 @@
 #ifndef DRMOCK_SRC_DRMOCK_MOCK_IMETHOD_H
 #define DRMOCK_SRC_DRMOCK_MOCK_IMETHOD_H
 
+#include <memory>
 #include <string>
+#include <vector>
+
+#include <DrMock/mock/CallRecord.h>
+#include <DrMock/mock/detail/Counter.h>
 
 namespace drmock {
 
+namespace detail {
+
+class Arena;
+
+} // namespace detail
+
 /**
  * Interface for method objects. We only need this for testing.
  */
@@ -33,6 +44,14 @@ public:
 
   virtual bool verify() const = 0;
   virtual std::string makeFormattedErrorString() const = 0;
+  // Return the recorded calls, oldest first.
+  virtual std::vector<CallRecord> makeCallRecords() const { return {}; }
+  // Forward the number of reasons why `verify()` fails to `counter`.
+  // Returns `false` if tracking is not supported.
+  virtual bool track(std::shared_ptr<detail::Counter>) { return false; }
+  // Remove all behaviors from the behavior queue, if any, and allocate
+  // future behaviors from `arena`.
+  virtual void clearQueue(std::shared_ptr<detail::Arena>) {}
 };
 
 } // namespace drmock
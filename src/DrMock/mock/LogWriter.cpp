@@ -0,0 +1,78 @@
+/* Copyright 2021 Ole Kliemann, Malte Kliemann
+ *
+ * This file is part of DrMock.
+ *
+ * DrMock is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DrMock is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DrMock.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "LogWriter.h"
+
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+
+namespace drmock {
+
+namespace {
+
+void
+checkSize(std::size_t size)
+{
+  if (size > std::numeric_limits<std::uint32_t>::max())
+  {
+    throw std::length_error{"LogWriter: record exceeds 4 GiB"};
+  }
+}
+
+void
+writeSize(std::ofstream& stream, std::size_t size)
+{
+  auto n = static_cast<std::uint32_t>(size);
+  stream.write(reinterpret_cast<const char*>(&n), sizeof(n));
+}
+
+} // anonymous namespace
+
+LogWriter::LogWriter(const std::string& path)
+:
+  stream_{path, std::ios::binary | std::ios::trunc}
+{
+  if (not stream_)
+  {
+    throw std::runtime_error{"LogWriter: cannot open " + path};
+  }
+  stream_.write(magic.data(), static_cast<std::streamsize>(magic.size()));
+}
+
+void
+LogWriter::write(std::string_view method, std::string_view payload)
+{
+  // Check before writing, so that a failure doesn't leave a truncated
+  // record behind.
+  checkSize(method.size());
+  checkSize(payload.size());
+  std::lock_guard<std::mutex> lck{mtx_};
+  writeSize(stream_, method.size());
+  stream_.write(method.data(), static_cast<std::streamsize>(method.size()));
+  writeSize(stream_, payload.size());
+  stream_.write(payload.data(), static_cast<std::streamsize>(payload.size()));
+}
+
+void
+LogWriter::flush()
+{
+  std::lock_guard<std::mutex> lck{mtx_};
+  stream_.flush();
+}
+
+} // namespace drmock
@@ -0,0 +1,75 @@
+/* Copyright 2021 Ole Kliemann, Malte Kliemann
+ *
+ * This file is part of DrMock.
+ *
+ * DrMock is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DrMock is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DrMock.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef DRMOCK_SRC_DRMOCK_MOCK_LOGWRITER_H
+#define DRMOCK_SRC_DRMOCK_MOCK_LOGWRITER_H
+
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+namespace drmock {
+
+/**
+ * Writes an interaction log for `Recorder` objects.
+ *
+ * An interaction log is a binary file which starts with the eight bytes
+ * `LogWriter::magic`, followed by records of the form
+ *
+ *   u32 length of method name | method name | u32 length of payload | payload
+ *
+ * where integers are stored in host byte order. The payload is opaque
+ * to the `LogWriter`; see `Recorder` for its layout. Interaction logs
+ * are read using `MappedLog`.
+ *
+ * `write` is thread-safe. The records of concurrent calls are written
+ * in the order in which `write` is entered.
+ */
+class LogWriter
+{
+public:
+  static constexpr std::string_view magic{"DRMOCK\x00\x01", 8};
+
+  /**
+   * Open `path` for writing, discarding its previous content.
+   *
+   * @throws std::runtime_error if `path` cannot be opened
+   */
+  LogWriter(const std::string& path);
+
+  /**
+   * Append a record to the log.
+   *
+   * @throws std::length_error if the size of `method` or `payload`
+   *   doesn't fit into 32 bits; nothing is written
+   */
+  void write(std::string_view method, std::string_view payload);
+
+  /**
+   * Write all buffered records to the file.
+   */
+  void flush();
+
+private:
+  std::mutex mtx_{};
+  std::ofstream stream_{};
+};
+
+} // namespace drmock
+
+#endif /* DRMOCK_SRC_DRMOCK_MOCK_LOGWRITER_H */
@@ -0,0 +1,150 @@
+/* Copyright 2021 Ole Kliemann, Malte Kliemann
+ *
+ * This file is part of DrMock.
+ *
+ * DrMock is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DrMock is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DrMock.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "MappedLog.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#include <iterator>
+#endif
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+#include <DrMock/mock/LogWriter.h>
+
+namespace drmock {
+
+namespace {
+
+std::size_t
+readSize(const char* data, std::size_t size, std::size_t& offset)
+{
+  std::uint32_t result;
+  if (size - offset < sizeof(result))
+  {
+    throw std::runtime_error{"MappedLog: truncated record"};
+  }
+  std::memcpy(&result, data + offset, sizeof(result));
+  offset += sizeof(result);
+  if (size - offset < result)
+  {
+    throw std::runtime_error{"MappedLog: truncated record"};
+  }
+  return result;
+}
+
+} // anonymous namespace
+
+MappedLog::MappedLog(const std::string& path)
+{
+#ifndef _WIN32
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd == -1)
+  {
+    throw std::runtime_error{"MappedLog: cannot open " + path};
+  }
+  struct stat st;
+  if (::fstat(fd, &st) == -1)
+  {
+    ::close(fd);
+    throw std::runtime_error{"MappedLog: cannot stat " + path};
+  }
+  size_ = static_cast<std::size_t>(st.st_size);
+  if (size_ >= LogWriter::magic.size())
+  {
+    void* addr = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (addr == MAP_FAILED)
+    {
+      ::close(fd);
+      throw std::runtime_error{"MappedLog: cannot map " + path};
+    }
+    data_ = static_cast<const char*>(addr);
+  }
+  ::close(fd);
+#else
+  std::ifstream stream{path, std::ios::binary};
+  if (not stream)
+  {
+    throw std::runtime_error{"MappedLog: cannot open " + path};
+  }
+  buffer_.assign(std::istreambuf_iterator<char>{stream}, std::istreambuf_iterator<char>{});
+  data_ = buffer_.data();
+  size_ = buffer_.size();
+#endif
+  if (size_ < LogWriter::magic.size() or std::string_view{data_, LogWriter::magic.size()} != LogWriter::magic)
+  {
+    unmap();
+    throw std::runtime_error{"MappedLog: " + path + " is not an interaction log"};
+  }
+}
+
+MappedLog::~MappedLog()
+{
+  unmap();
+}
+
+void
+MappedLog::unmap()
+{
+#ifndef _WIN32
+  if (data_)
+  {
+    ::munmap(const_cast<char*>(data_), size_);
+    data_ = nullptr;
+  }
+#endif
+}
+
+std::size_t
+MappedLog::begin() const
+{
+  return LogWriter::magic.size();
+}
+
+std::optional<MappedLog::Record>
+MappedLog::find(std::string_view method, std::size_t offset) const
+{
+  while (offset < size_)
+  {
+    auto name_size = readSize(data_, size_, offset);
+    std::string_view name{data_ + offset, name_size};
+    offset += name_size;
+    auto payload_size = readSize(data_, size_, offset);
+    std::string_view payload{data_ + offset, payload_size};
+    offset += payload_size;
+    if (name == method)
+    {
+      return Record{name, payload, offset};
+    }
+  }
+  return std::nullopt;
+}
+
+std::size_t
+MappedLog::size() const
+{
+  return size_;
+}
+
+} // namespace drmock
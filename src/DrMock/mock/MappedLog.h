@@ -0,0 +1,90 @@
+/* Copyright 2021 Ole Kliemann, Malte Kliemann
+ *
+ * This file is part of DrMock.
+ *
+ * DrMock is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DrMock is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DrMock.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef DRMOCK_SRC_DRMOCK_MOCK_MAPPEDLOG_H
+#define DRMOCK_SRC_DRMOCK_MOCK_MAPPEDLOG_H
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace drmock {
+
+/**
+ * Read-only view of an interaction log written by `LogWriter`.
+ *
+ * The file is memory-mapped (on Windows, it is read into memory), so
+ * records are only paged in when they are read. Records are not
+ * parsed in advance; `find` scans the log from a given offset.
+ *
+ * All methods are `const` and thread-safe. The log file must not be
+ * modified while it is mapped.
+ */
+class MappedLog
+{
+public:
+  struct Record
+  {
+    std::string_view method;  /**> The name of the method */
+    std::string_view payload;  /**> The payload, see `Recorder` */
+    std::size_t next;  /**> The offset of the next record */
+  };
+
+  /**
+   * Map the interaction log at `path`.
+   *
+   * @throws std::runtime_error if `path` cannot be opened or is not an
+   *   interaction log
+   */
+  MappedLog(const std::string& path);
+  ~MappedLog();
+
+  MappedLog(const MappedLog&) = delete;
+  MappedLog& operator=(const MappedLog&) = delete;
+
+  /**
+   * Return the offset of the first record.
+   */
+  std::size_t begin() const;
+
+  /**
+   * Return the first record of `method` at or after `offset`, or
+   * `std::nullopt` if there is none.
+   *
+   * @throws std::runtime_error if a truncated record is encountered
+   */
+  std::optional<Record> find(std::string_view method, std::size_t offset) const;
+
+  /**
+   * Return the size of the log in bytes.
+   */
+  std::size_t size() const;
+
+private:
+  void unmap();
+
+  const char* data_ = nullptr;
+  std::size_t size_ = 0;
+#ifdef _WIN32
+  std::string buffer_{};
+#endif
+};
+
+} // namespace drmock
+
+#endif /* DRMOCK_SRC_DRMOCK_MOCK_MAPPEDLOG_H */
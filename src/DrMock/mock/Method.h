@@ -19,16 +19,30 @@
 #ifndef DRMOCK_SRC_DRMOCK_MOCK_METHOD_H
 #define DRMOCK_SRC_DRMOCK_MOCK_METHOD_H
 
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
 #include <vector>
 
 #include <DrMock/mock/AbstractBehavior.h>
 #include <DrMock/mock/Behavior.h>
 #include <DrMock/mock/BehaviorQueue.h>
 #include <DrMock/mock/IMethod.h>
+#include <DrMock/mock/MappedLog.h>
+#include <DrMock/mock/Replay.h>
 #include <DrMock/mock/StateBehavior.h>
 #include <DrMock/mock/StateObject.h>
+#include <DrMock/mock/detail/IsEqual.h>
+#include <DrMock/mock/detail/Journal.h>
+#include <DrMock/utility/detail/TypeTraits.h>
 
 namespace drmock {
 
@@ -71,6 +85,12 @@ class Method final : public IMethod
   using DecayedReturnType = typename std::decay<ReturnType>::type;
 
 public:
+  /**
+   * A recorded call (see `Method::record`). `args` is empty if the
+   * arguments are not copy-constructible.
+   */
+  using Call = typename detail::Journal<Args...>::Entry;
+
   Method();
   /**
    * @param name The name of the method
@@ -120,44 +140,165 @@ public:
    */
   void enforce_order(bool);
 
+  /**
+   * Convenience method; calls `concurrent()` on the internal behavior
+   * queue (without activating it).
+   *
+   * Call this before calling `this` from several threads at once.
+   * `StateBehavior` and the recording of failed calls are always
+   * thread-safe.
+   */
+  void concurrent(bool);
+
+  /**
+   * Remove all behaviors from the internal behavior queue.
+   *
+   * Behaviors are allocated from the arena of the mock, which is only
+   * released when the mock is destroyed. The queue stays in the arena
+   * shared with the other methods of the mock, so the memory of the
+   * removed behaviors is only released by `Controller::clearQueues`,
+   * which moves all methods to a new arena at once. References to the
+   * removed behaviors are invalidated. Must not be called while calls
+   * are in flight.
+   */
+  void clearQueue();
+  /**
+   * Remove all behaviors from the internal behavior queue and allocate
+   * future behaviors from `arena`.
+   *
+   * Used by `Controller::clearQueues` after renewing the arena of the
+   * mock (see `StateObject::renewArena`).
+   */
+  void clearQueue(std::shared_ptr<detail::Arena> arena) override;
+
   /**
    * Enable `StateBehavior` usage and return a reference.
    */
   StateBehavior<Class, ReturnType, Args...>& state();
 
   /**
-   * Check if any calls have failed.
+   * Enable replay of the calls recorded for `this` in `log` and return
+   * a reference to the replay.
+   *
+   * The records are looked up by the name of `this` (see `Recorder`
+   * and `Replay`). Like the behavior queue, the replay fails
+   * verification until all records have been replayed. The behavior
+   * queue is no longer verified.
+   *
+   * @throws std::logic_error if `drutility::detail::Serializer` is not
+   *   defined for all parameter types and the return type
+   */
+  Replay<Class, ReturnType, Args...>& replay(std::shared_ptr<MappedLog> log);
+
+  /**
+   * Check if any calls have failed (or, if the behavior queue is used,
+   * if the queue is exhausted).
+   *
+   * Takes constant time.
    */
   bool verify() const override;
 
+  /**
+   * Forward the number of reasons why `verify()` fails (failed calls
+   * count as one, and every behavior of the queue which is not
+   * exhausted counts as one) to `counter`. Used by `Controller`.
+   */
+  bool track(std::shared_ptr<detail::Counter> counter) override;
+
   /**
    * Return error messages for failed calls.
    *
    * @returns A row-major matrix, rows are failed calls, columns contain
    *   the arguments of these calls.
+   *
+   * Only the first and last calls captured according to
+   * `capture_limit` are returned.
    */
-  const std::vector<std::vector<std::string>>& error_msgs() const;
+  std::vector<std::vector<std::string>> error_msgs() const;
 
   /**
    * Return a printable version of the error messages.
    */
   std::string makeFormattedErrorString() const override;
 
+  /**
+   * Set the number of failed calls which are captured in full.
+   *
+   * The arguments of the first `k` and the last `k` failed calls are
+   * captured. The remaining calls are only counted, grouped by equal
+   * arguments (if the arguments are hashable, see
+   * `detail::is_hashable_by_equality_v`). At most `k` groups are kept,
+   * including one sample call each. Arguments which own their value
+   * are copied and not converted to strings until the error messages
+   * are requested. Pointers (including `std::shared_ptr`), views and
+   * iterators are converted to strings immediately.
+   *
+   * The default is 16. Must be called before the first call fails.
+   */
+  void capture_limit(std::size_t k);
+
+  /**
+   * Return the number of failed calls.
+   */
+  std::size_t num_failed_calls() const;
+
+  /**
+   * Record the arguments of the last `capacity` calls (successful or
+   * not) together with their time and global sequence number.
+   *
+   * The memory for the records is allocated when `record` is called,
+   * so leaving the recording on doesn't cause unbounded growth. Calling
+   * `record` again discards all records; `record(0)` stops recording.
+   * Must not be called while calls are in flight.
+   *
+   * The arguments are copied into the records if they're
+   * self-contained (see `drutility::detail::is_self_contained`).
+   * Otherwise, they're converted to strings when they're recorded, and
+   * `Call::args` is empty (see `detail::Journal`).
+   */
+  void record(std::size_t capacity);
+
+  /**
+   * Return the recorded calls, oldest first.
+   */
+  std::vector<Call> calls() const;
+
+  /**
+   * Return the number of calls recorded since the last call of
+   * `record`, including those which were overwritten.
+   */
+  std::size_t num_recorded_calls() const;
+
+  /**
+   * Return the recorded calls with printed arguments, oldest first.
+   */
+  std::vector<CallRecord> makeCallRecords() const override;
+
   /**
    * When the Method is called with `args...`, the call is forwarded to the
    * currently selected behavior:
    * 
    * - Any produced std::exception_ptr is re-thrown.
-   * - Any produced std::shared_ptr is returned.
+   * - A pointer to any produced return value is returned.
    * - If the Method's return value is void, then a nullptr is returned.
    * 
    * If none of those occur, the call is considered to have _failed_. Any
    * future call of verify() will now return `false` (per default, it returns
    * `true`). An error message is printed, and then, If the return value of
-   * Method is default constructible or void, then the default or a nullptr
-   * is returned. Otherwise, `std::abort()` is called.
+   * Method is default constructible or void, then a pointer to the default
+   * or a nullptr is returned. Otherwise, `std::abort()` is called.
+   *
+   * The returned pointer points to the value stored in the behavior
+   * and remains valid as long as `this` does.
+   *
+   * If the behavior queue is active and its front is a stub (see
+   * `BehaviorQueue::stub`), the result of the stub is returned directly
+   * without dispatching through the queue. The stub is looked up once
+   * after `push`, `io`, `state`, `replay` or `clearQueue`, so a stub
+   * must not be reconfigured through a retained reference once `this`
+   * has been called.
    */
-  std::shared_ptr<DecayedReturnType> call(const Args&...);
+  DecayedReturnType* call(const Args&...);
 
   /**
    * Set the object that owns the method.
@@ -168,13 +309,51 @@ private:
   std::string name_{};
   std::shared_ptr<detail::IMakeTupleOfMatchers<Args...>> make_tuple_of_matchers_{};
   std::shared_ptr<StateObject> state_object_{};  /**> Internal state object. Only used for dependency injection. */
-  // The currently used AbstractBehavior (`state_behavior_` or
-  // `behavior_queue_`) is `behavior_`, while the other is a nullptr.
+  // The currently used AbstractBehavior (`state_behavior_`,
+  // `behavior_queue_` or `replay_`) is `behavior_`.
   std::shared_ptr<StateBehavior<Class, ReturnType, Args...>> state_behavior_{};
   std::shared_ptr<BehaviorQueue<Class, ReturnType, Args...>> behavior_queue_{};
+  std::shared_ptr<Replay<Class, ReturnType, Args...>> replay_{};
   std::shared_ptr<AbstractBehavior<Class, ReturnType, Args...>> behavior_{};
-  bool has_failed_ = false;  /**> `true` if `call` encountered unexpected args */
-  std::vector<std::vector<std::string>> error_msgs_{};
+  // Cache of `behavior_queue_->stub()` if `behavior_queue_` is active,
+  // otherwise `nullptr`. Computed by `call` unless `stub_cached_` is
+  // set, and invalidated whenever the behaviors may be reconfigured.
+  std::atomic<Behavior<Class, ReturnType, Args...>*> stub_{nullptr};
+  std::atomic<bool> stub_cached_{false};
+  void invalidateStub();
+  // A failed call. If all arguments are self-contained (see
+  // `drutility::detail::is_self_contained`), they are copied and
+  // rendered on demand. Otherwise, they are rendered immediately:
+  // Copies could dangle, or keep objects alive that the code under test
+  // expects to be destroyed.
+  struct FailedCall
+  {
+    static constexpr bool copy_args = (std::is_copy_constructible_v<Args> and ...)
+        and (drutility::detail::is_self_contained_v<std::decay_t<Args>> and ...);
+
+    std::optional<std::size_t> hash{};  /**> Hash of the arguments, if hashable */
+    std::shared_ptr<const std::tuple<Args...>> args{};  /**> Used if `copy_args` */
+    std::vector<std::string> strings{};  /**> Used unless `copy_args` */
+
+    std::vector<std::string> render() const;
+    // Return `true` if the calls were made with equal arguments.
+    bool equals(const FailedCall& other) const;
+  };
+  FailedCall makeFailedCall(const Args&... args) const;
+  void addFailedCall(const Args&... args);  // Requires `failure_mtx_`
+
+  std::atomic<bool> has_failed_{false};  /**> `true` if `call` encountered unexpected args */
+  std::shared_ptr<detail::Counter> unverified_{std::make_shared<detail::Counter>()};  /**> Number of reasons why `verify` fails */
+  mutable std::mutex failure_mtx_{};  /**> Guards the failed calls and `panic_value_` */
+  std::size_t capture_limit_ = 16;
+  std::size_t num_failed_calls_ = 0;
+  std::vector<FailedCall> first_failed_calls_{};  /**> The first `capture_limit_` failed calls */
+  std::deque<FailedCall> last_failed_calls_{};  /**> The last `capture_limit_` failed calls after those */
+  // The remaining failed calls, grouped by equal arguments: hash ->
+  // (count, sample), and the number of calls that fit into no group.
+  std::unordered_multimap<std::size_t, std::pair<std::size_t, FailedCall>> omitted_calls_{};
+  std::size_t num_other_omitted_calls_ = 0;
+  std::unique_ptr<detail::Journal<Args...>> journal_{};  /**> The recorded calls; `nullptr` unless recording */
   Class* parent_;  /**> Pointer to the owner of the method */
   std::shared_ptr<DecayedReturnType> panic_value_{}; /**> Used to store default return value */
 };
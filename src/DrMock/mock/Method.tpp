@@ -16,6 +16,12 @@
  * along with DrMock.  If not, see <https://www.gnu.org/licenses/>.
 */
 
+#include <algorithm>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+
+#include <DrMock/mock/detail/Hash.h>
 #include <DrMock/utility/detail/Diagnostics.h>
 
 namespace drmock {
@@ -42,12 +48,19 @@ template<typename Class, typename ReturnType, typename... Args>
 Method<Class, ReturnType, Args...>::Method(std::string name, std::shared_ptr<StateObject> state_object)
 :
   name_{std::move(name)},
-  make_tuple_of_matchers_{std::make_shared<detail::MakeTupleOfMatchers<std::tuple<Args...>>>()},
+  make_tuple_of_matchers_{std::make_shared<detail::MakeTupleOfMatchers<std::tuple<Args...>>>(
+      state_object->arena()
+    )},
   state_object_{std::move(state_object)},
   state_behavior_{},
-  behavior_queue_{std::make_shared<BehaviorQueue<Class, ReturnType, Args...>>(make_tuple_of_matchers_)},
+  behavior_queue_{std::make_shared<BehaviorQueue<Class, ReturnType, Args...>>(
+      make_tuple_of_matchers_,
+      state_object_->arena()
+    )},
   behavior_{behavior_queue_}
-{}
+{
+  behavior_queue_->track(unverified_);
+}
 
 template<typename Class, typename ReturnType, typename... Args>
 BehaviorQueue<Class, ReturnType, Args...>&
@@ -55,9 +68,13 @@ Method<Class, ReturnType, Args...>::io()
 {
   if (not behavior_queue_)
   {
-    behavior_queue_ = std::make_shared<BehaviorQueue<Class, ReturnType, Args...>>(make_tuple_of_matchers_);
+    behavior_queue_ = std::make_shared<BehaviorQueue<Class, ReturnType, Args...>>(
+        make_tuple_of_matchers_,
+        state_object_->arena()
+      );
   }
   behavior_ = behavior_queue_;
+  invalidateStub();
   return *behavior_queue_;
 }
 
@@ -75,6 +92,29 @@ Method<Class, ReturnType, Args...>::enforce_order(bool value)
   io().enforce_order(value);
 }
 
+template<typename Class, typename ReturnType, typename... Args>
+void
+Method<Class, ReturnType, Args...>::concurrent(bool value)
+{
+  behavior_queue_->concurrent(value);
+}
+
+template<typename Class, typename ReturnType, typename... Args>
+void
+Method<Class, ReturnType, Args...>::clearQueue()
+{
+  clearQueue(state_object_->arena());
+}
+
+template<typename Class, typename ReturnType, typename... Args>
+void
+Method<Class, ReturnType, Args...>::clearQueue(std::shared_ptr<detail::Arena> arena)
+{
+  make_tuple_of_matchers_ = make_tuple_of_matchers_->rebind(arena);
+  behavior_queue_->clear(make_tuple_of_matchers_, std::move(arena));
+  invalidateStub();
+}
+
 template<typename Class, typename ReturnType, typename... Args>
 StateBehavior<Class, ReturnType, Args...>&
 Method<Class, ReturnType, Args...>::state()
@@ -85,11 +125,30 @@ Method<Class, ReturnType, Args...>::state()
         state_object_,
         make_tuple_of_matchers_
       );
+    // The queue is no longer verified.
+    behavior_queue_->track(nullptr);
   }
   behavior_ = state_behavior_;
+  invalidateStub();
   return *state_behavior_;
 }
 
+template<typename Class, typename ReturnType, typename... Args>
+Replay<Class, ReturnType, Args...>&
+Method<Class, ReturnType, Args...>::replay(std::shared_ptr<MappedLog> log)
+{
+  if (not Replay<Class, ReturnType, Args...>::serializable)
+  {
+    throw std::logic_error{"Method::replay: Serializer is not defined for all parameter types and the return type"};
+  }
+  replay_ = std::make_shared<Replay<Class, ReturnType, Args...>>(std::move(log), name_);
+  behavior_queue_->track(nullptr);
+  replay_->track(unverified_);
+  behavior_ = replay_;
+  invalidateStub();
+  return *replay_;
+}
+
 template<typename Class, typename ReturnType, typename... Args>
 template<typename... Deriveds>
 void
@@ -98,7 +157,7 @@ Method<Class, ReturnType, Args...>::polymorphic()
   make_tuple_of_matchers_ = std::make_shared<detail::MakeTupleOfMatchers<
       std::tuple<Args...>,
       std::tuple<Deriveds...>
-    >>();
+    >>(state_object_->arena());
   if (behavior_queue_)
   {
     behavior_queue_->template polymorphic<Deriveds...>();
@@ -113,38 +172,263 @@ template<typename Class, typename ReturnType, typename... Args>
 bool
 Method<Class, ReturnType, Args...>::verify() const
 {
-  // If behavior_queue_ is used for verification, check if it's
-  // exhausted.
-  if (not state_behavior_)
+  // If behavior_queue_ is used for verification, it contributes its
+  // unsatisfied behaviors to `unverified_`.
+  return unverified_->get() == 0;
+}
+
+template<typename Class, typename ReturnType, typename... Args>
+bool
+Method<Class, ReturnType, Args...>::track(std::shared_ptr<detail::Counter> counter)
+{
+  unverified_->parent(std::move(counter));
+  return true;
+}
+
+template<typename Class, typename ReturnType, typename... Args>
+std::vector<std::vector<std::string>>
+Method<Class, ReturnType, Args...>::error_msgs() const
+{
+  std::lock_guard<std::mutex> lck{failure_mtx_};
+  std::vector<std::vector<std::string>> result{};
+  result.reserve(first_failed_calls_.size() + last_failed_calls_.size());
+  for (const auto& v : first_failed_calls_)
   {
-    return (not has_failed_) and behavior_queue_->is_exhausted();
+    result.push_back(v.render());
   }
-  return not has_failed_;
+  for (const auto& v : last_failed_calls_)
+  {
+    result.push_back(v.render());
+  }
+  return result;
 }
 
 template<typename Class, typename ReturnType, typename... Args>
-const std::vector<std::vector<std::string>>&
-Method<Class, ReturnType, Args...>::error_msgs() const
+void
+Method<Class, ReturnType, Args...>::capture_limit(std::size_t k)
+{
+  std::lock_guard<std::mutex> lck{failure_mtx_};
+  capture_limit_ = k;
+}
+
+template<typename Class, typename ReturnType, typename... Args>
+std::size_t
+Method<Class, ReturnType, Args...>::num_failed_calls() const
+{
+  std::lock_guard<std::mutex> lck{failure_mtx_};
+  return num_failed_calls_;
+}
+
+template<typename Class, typename ReturnType, typename... Args>
+void
+Method<Class, ReturnType, Args...>::record(std::size_t capacity)
+{
+  if (capacity == 0)
+  {
+    journal_.reset();
+  }
+  else
+  {
+    journal_ = std::make_unique<detail::Journal<Args...>>(capacity);
+  }
+}
+
+template<typename Class, typename ReturnType, typename... Args>
+std::vector<typename Method<Class, ReturnType, Args...>::Call>
+Method<Class, ReturnType, Args...>::calls() const
+{
+  if (not journal_)
+  {
+    return {};
+  }
+  return journal_->entries();
+}
+
+template<typename Class, typename ReturnType, typename... Args>
+std::size_t
+Method<Class, ReturnType, Args...>::num_recorded_calls() const
+{
+  if (not journal_)
+  {
+    return 0;
+  }
+  return journal_->num_recorded();
+}
+
+template<typename Class, typename ReturnType, typename... Args>
+std::vector<CallRecord>
+Method<Class, ReturnType, Args...>::makeCallRecords() const
+{
+  std::vector<CallRecord> result{};
+  for (const auto& call : calls())
+  {
+    CallRecord record{name_, call.sequence, call.time, {}};
+    if constexpr (detail::Journal<Args...>::copyable)
+    {
+      if (call.args)
+      {
+        std::apply(
+            [&record] (const auto&... xs) { drutility::detail::PrintAll<Args...>{}(record.args, xs...); },
+            *call.args
+          );
+      }
+    }
+    else if constexpr (detail::Journal<Args...>::rendered)
+    {
+      record.args = call.strings;
+    }
+    result.push_back(std::move(record));
+  }
+  return result;
+}
+
+template<typename Class, typename ReturnType, typename... Args>
+std::vector<std::string>
+Method<Class, ReturnType, Args...>::FailedCall::render() const
 {
-  return error_msgs_;
+  if constexpr (copy_args)
+  {
+    std::vector<std::string> result{};
+    std::apply(
+        [&result] (const auto&... xs) { drutility::detail::PrintAll<Args...>{}(result, xs...); },
+        *args
+      );
+    return result;
+  }
+  else
+  {
+    return strings;
+  }
+}
+
+template<typename Class, typename ReturnType, typename... Args>
+bool
+Method<Class, ReturnType, Args...>::FailedCall::equals(const FailedCall& other) const
+{
+  if constexpr (copy_args)
+  {
+    return detail::IsEqual<std::tuple<Args...>>{}(*args, *other.args);
+  }
+  else
+  {
+    return strings == other.strings;
+  }
+}
+
+template<typename Class, typename ReturnType, typename... Args>
+typename Method<Class, ReturnType, Args...>::FailedCall
+Method<Class, ReturnType, Args...>::makeFailedCall(const Args&... args) const
+{
+  FailedCall result{};
+  if constexpr ((detail::is_hashable_by_equality_v<Args> and ...))
+  {
+    result.hash = detail::hashAll(args...);
+  }
+  if constexpr (FailedCall::copy_args)
+  {
+    result.args = std::make_shared<const std::tuple<Args...>>(args...);
+  }
+  else
+  {
+    drutility::detail::PrintAll<Args...>{}(result.strings, args...);
+  }
+  return result;
+}
+
+template<typename Class, typename ReturnType, typename... Args>
+void
+Method<Class, ReturnType, Args...>::addFailedCall(const Args&... args)
+{
+  ++num_failed_calls_;
+  if (first_failed_calls_.size() < capture_limit_)
+  {
+    first_failed_calls_.push_back(makeFailedCall(args...));
+    return;
+  }
+  if (capture_limit_ == 0)
+  {
+    ++num_other_omitted_calls_;
+    return;
+  }
+
+  last_failed_calls_.push_back(makeFailedCall(args...));
+  if (last_failed_calls_.size() <= capture_limit_)
+  {
+    return;
+  }
+
+  // Move the oldest of the last calls into the histogram. Calls with
+  // equal hashes may still differ, so the groups are compared.
+  auto call = std::move(last_failed_calls_.front());
+  last_failed_calls_.pop_front();
+  if constexpr ((detail::is_hashable_by_equality_v<Args> and ...))
+  {
+    auto [first, last] = omitted_calls_.equal_range(*call.hash);
+    for (auto it = first; it != last; ++it)
+    {
+      if (it->second.second.equals(call))
+      {
+        ++it->second.first;
+        return;
+      }
+    }
+    if (omitted_calls_.size() < capture_limit_)
+    {
+      omitted_calls_.emplace(*call.hash, std::make_pair(std::size_t{1}, std::move(call)));
+      return;
+    }
+  }
+  ++num_other_omitted_calls_;
 }
 
 template<typename Class, typename ReturnType, typename... Args>
-std::shared_ptr<typename std::decay<ReturnType>::type>
+typename std::decay<ReturnType>::type*
 Method<Class, ReturnType, Args...>::call(const Args&... args)
 {
+  if (journal_)
+  {
+    journal_->record(args...);
+  }
+
+  // Fast path for `push().expects().returns(x).persists()` and the like.
+  if (not stub_cached_.load(std::memory_order_acquire))
+  {
+    stub_.store(
+        behavior_ == behavior_queue_ ? behavior_queue_->stub() : nullptr,
+        std::memory_order_relaxed
+      );
+    stub_cached_.store(true, std::memory_order_release);
+  }
+  if (auto stub = stub_.load(std::memory_order_relaxed))
+  {
+    // A stub persists, so the productions it counts in `claim` are
+    // never observed and needn't be counted.
+    auto [rv, signal] = stub->result();
+    if (signal)
+    {
+      signal->invoke(parent_);
+    }
+    return rv;
+  }
+
+  // Dispatching through the queue may exhaust its first persistent
+  // behavior and leave a stub in its place (see
+  // `BehaviorQueue::stub`), so look again next time.
+  if (behavior_ == behavior_queue_)
+  {
+    stub_cached_.store(false, std::memory_order_relaxed);
+  }
   auto result = behavior_->call(args...);
   if (std::holds_alternative<std::exception_ptr>(result))
   {
     std::rethrow_exception(std::get<std::exception_ptr>(result));
   }
-  else if (std::holds_alternative<std::pair<std::shared_ptr<typename std::decay<ReturnType>::type>, std::shared_ptr<AbstractSignal<Class>>>>(result))
+  else if (auto p = std::get_if<detail::ResultRef<Class, ReturnType>>(&result))
   {
-    auto p = std::get<std::pair<std::shared_ptr<typename std::decay<ReturnType>::type>, std::shared_ptr<AbstractSignal<Class>>>>(result);
-    auto rv = p.first;
+    auto rv = p->first;
     if (rv or std::is_same_v<DecayedReturnType, void>)
     {
-      auto signal_name = p.second;
+      auto signal_name = p->second;
       if (signal_name)
       {
         signal_name->invoke(parent_);
@@ -153,9 +437,12 @@ Method<Class, ReturnType, Args...>::call(const Args&... args)
     }
   }
 
-  has_failed_ = true;
-  error_msgs_.push_back({});
-  drutility::detail::PrintAll<Args...>{}(error_msgs_.back(), args...);
+  if (not has_failed_.exchange(true))
+  {
+    unverified_->add(1);
+  }
+  std::lock_guard<std::mutex> lck{failure_mtx_};
+  addFailedCall(args...);
 
   if constexpr (std::is_default_constructible_v<DecayedReturnType>)
   {
@@ -163,11 +450,11 @@ Method<Class, ReturnType, Args...>::call(const Args&... args)
     {
       panic_value_ = std::make_shared<DecayedReturnType>();
     }
-    return panic_value_;
+    return panic_value_.get();
   }
   else if constexpr(std::is_same_v<DecayedReturnType, void>)
   {
-    return {};
+    return nullptr;
   }
   else
   {
@@ -179,15 +466,52 @@ template<typename Class, typename ReturnType, typename... Args>
 std::string
 Method<Class, ReturnType, Args...>::makeFormattedErrorString() const
 {
+  std::lock_guard<std::mutex> lck{failure_mtx_};
   std::stringstream s{};
   s << std::endl << "  Method \"" << name_ << "\" failed because" << std::endl;
-  for (auto& outer : error_msgs_)
+  auto print_call = [&s] (const FailedCall& call, const std::string& indent) {
+      for (auto& inner : call.render())
+      {
+        s << indent << inner << std::endl;
+      }
+    };
+  for (const auto& call : first_failed_calls_)
   {
     s << "  " << "  " << "no behavior specified for call" << std::endl;
-    for (auto& inner : outer)
+    print_call(call, "      ");
+  }
+
+  auto num_omitted = num_failed_calls_ - first_failed_calls_.size() - last_failed_calls_.size();
+  if (num_omitted > 0)
+  {
+    s << "  " << "  " << "no behavior specified for " << num_omitted << " more calls";
+    if (not omitted_calls_.empty())
     {
-      s << "  " << "  " << "  " << inner << std::endl;
+      s << ", including";
     }
+    s << std::endl;
+
+    // Print the groups with the most calls first.
+    std::vector<const std::pair<std::size_t, FailedCall>*> groups{};
+    for (const auto& v : omitted_calls_)
+    {
+      groups.push_back(&v.second);
+    }
+    std::stable_sort(
+        groups.begin(), groups.end(),
+        [] (auto lhs, auto rhs) { return lhs->first > rhs->first; }
+      );
+    for (auto group : groups)
+    {
+      s << "  " << "  " << "  " << group->first << " calls with" << std::endl;
+      print_call(group->second, "        ");
+    }
+  }
+
+  for (const auto& call : last_failed_calls_)
+  {
+    s << "  " << "  " << "no behavior specified for call" << std::endl;
+    print_call(call, "      ");
   }
   return s.str();
 }
@@ -199,4 +523,11 @@ Method<Class, ReturnType, Args...>::parent(Class* parent)
   parent_ = parent;
 }
 
+template<typename Class, typename ReturnType, typename... Args>
+void
+Method<Class, ReturnType, Args...>::invalidateStub()
+{
+  stub_cached_.store(false, std::memory_order_release);
+}
+
 } // namespace drmock
@@ -0,0 +1,93 @@
+/* Copyright 2021 Ole Kliemann, Malte Kliemann
+ *
+ * This file is part of DrMock.
+ *
+ * DrMock is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DrMock is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DrMock.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef DRMOCK_SRC_DRMOCK_MOCK_RECORDER_H
+#define DRMOCK_SRC_DRMOCK_MOCK_RECORDER_H
+
+#include <functional>
+#include <memory>
+#include <string>
+
+#include <DrMock/mock/LogWriter.h>
+#include <DrMock/utility/detail/Serializer.h>
+
+namespace drmock {
+
+/**
+ * Records the calls of a real implementation of a method to an
+ * interaction log.
+ *
+ * @tparam ReturnType The return type of the method
+ * @tparam Args... The parameter types of the method
+ *
+ * A `Recorder` wraps a callable (usually a lambda which calls the
+ * method on a real object) and forwards all calls to it. Every call is
+ * appended to the log, tagged with the name of the method. The payload
+ * of the record consists of the serialized arguments, followed by a
+ * byte which is `0` if the call returned, or `1` if it threw. In the
+ * first case, the serialized return value follows (unless `ReturnType`
+ * is `void`), in the second case, `what()` follows (or
+ * `"unknown exception"` if the exception isn't derived from
+ * `std::exception`). The exception is rethrown.
+ *
+ * Arguments and return values are serialized using
+ * `drutility::detail::Serializer`, which must be defined for them.
+ *
+ * The log may be replayed using `Method::replay`. To record an entire
+ * interface, wrap each of its methods in a `Recorder` sharing the same
+ * `LogWriter`.
+ */
+template<typename ReturnType, typename... Args>
+class Recorder
+{
+  static_assert(
+      drutility::detail::is_serializable_v<Args...>,
+      "Recorder: Serializer is not defined for all parameter types"
+    );
+  static_assert(
+      std::is_void_v<ReturnType> or drutility::detail::is_serializable_v<ReturnType>,
+      "Recorder: Serializer is not defined for the return type"
+    );
+
+public:
+  /**
+   * @param writer The log to write to
+   * @param name The name of the method
+   * @param impl The real implementation
+   */
+  Recorder(
+      std::shared_ptr<LogWriter> writer,
+      std::string name,
+      std::function<ReturnType(Args...)> impl
+    );
+
+  /**
+   * Call the implementation with `args...` and record the call.
+   */
+  ReturnType operator()(Args... args);
+
+private:
+  std::shared_ptr<LogWriter> writer_{};
+  std::string name_{};
+  std::function<ReturnType(Args...)> impl_{};
+};
+
+} // namespace drmock
+
+#include "Recorder.tpp"
+
+#endif /* DRMOCK_SRC_DRMOCK_MOCK_RECORDER_H */
@@ -0,0 +1,86 @@
+/* Copyright 2021 Ole Kliemann, Malte Kliemann
+ *
+ * This file is part of DrMock.
+ *
+ * DrMock is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DrMock is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DrMock.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include <exception>
+#include <type_traits>
+#include <utility>
+
+#include <DrMock/mock/detail/Outcome.h>
+
+namespace drmock {
+
+template<typename ReturnType, typename... Args>
+Recorder<ReturnType, Args...>::Recorder(
+    std::shared_ptr<LogWriter> writer,
+    std::string name,
+    std::function<ReturnType(Args...)> impl
+  )
+:
+  writer_{std::move(writer)},
+  name_{std::move(name)},
+  impl_{std::move(impl)}
+{}
+
+template<typename ReturnType, typename... Args>
+ReturnType
+Recorder<ReturnType, Args...>::operator()(Args... args)
+{
+  using drutility::detail::Serializer;
+
+  // Serialize the arguments before they're forwarded (and possibly
+  // moved from).
+  std::string payload{};
+  (Serializer<std::decay_t<Args>>::write(payload, args), ...);
+
+  auto invoke = [this, &payload, &args...] () -> ReturnType {
+      try
+      {
+        return impl_(std::forward<Args>(args)...);
+      }
+      catch (const std::exception& e)
+      {
+        Serializer<std::uint8_t>::write(payload, static_cast<std::uint8_t>(detail::Outcome::exception));
+        Serializer<std::string>::write(payload, e.what());
+        writer_->write(name_, payload);
+        throw;
+      }
+      catch (...)
+      {
+        Serializer<std::uint8_t>::write(payload, static_cast<std::uint8_t>(detail::Outcome::exception));
+        Serializer<std::string>::write(payload, "unknown exception");
+        writer_->write(name_, payload);
+        throw;
+      }
+    };
+
+  if constexpr (std::is_void_v<ReturnType>)
+  {
+    invoke();
+    Serializer<std::uint8_t>::write(payload, static_cast<std::uint8_t>(detail::Outcome::value));
+    writer_->write(name_, payload);
+  }
+  else
+  {
+    ReturnType result = invoke();
+    Serializer<std::uint8_t>::write(payload, static_cast<std::uint8_t>(detail::Outcome::value));
+    Serializer<std::decay_t<ReturnType>>::write(payload, result);
+    writer_->write(name_, payload);
+    return std::forward<ReturnType>(result);
+  }
+}
+
+} // namespace drmock
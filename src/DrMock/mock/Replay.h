@@ -0,0 +1,109 @@
+/* Copyright 2021 Ole Kliemann, Malte Kliemann
+ *
+ * This file is part of DrMock.
+ *
+ * DrMock is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DrMock is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DrMock.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef DRMOCK_SRC_DRMOCK_MOCK_REPLAY_H
+#define DRMOCK_SRC_DRMOCK_MOCK_REPLAY_H
+
+#include <deque>
+#include <memory>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <variant>
+
+#include <DrMock/mock/AbstractBehavior.h>
+#include <DrMock/mock/MappedLog.h>
+#include <DrMock/mock/detail/Counter.h>
+#include <DrMock/utility/detail/Serializer.h>
+
+namespace drmock {
+
+/**
+ * Behavior that replays the calls of a method recorded by `Recorder`.
+ *
+ * @tparam Class The class that the method belongs to
+ * @tparam ReturnType The return type of the method
+ * @tparam Args... The parameter types of the method
+ *
+ * The records of the method are streamed from a `MappedLog` in the
+ * order in which they were recorded; only the next record is held in
+ * memory. If a call matches the arguments of the next record (compared
+ * using `detail::IsEqual`), the recorded result is produced and the
+ * replay advances to the following record. A recorded exception is
+ * produced as `std::runtime_error` with the recorded `what()`. A call
+ * that doesn't match produces nothing and doesn't advance the replay.
+ *
+ * The replayed return values are kept, so that, as with the other
+ * behaviors, the pointer to the return value remains valid as long as
+ * `this` does (see `Method::call`). `Replay` must not be called
+ * concurrently.
+ *
+ * If `drutility::detail::Serializer` is not defined for all parameter
+ * types and the return type, then `serializable` is `false` and every
+ * call produces nothing.
+ */
+template<typename Class, typename ReturnType, typename... Args>
+class Replay final : public AbstractBehavior<Class, ReturnType, Args...>
+{
+  using DecayedReturnType = std::decay_t<ReturnType>;
+
+public:
+  static constexpr bool serializable = (
+      drutility::detail::is_serializable_v<Args...>
+      and (std::is_void_v<DecayedReturnType> or drutility::detail::is_serializable_v<DecayedReturnType>)
+    );
+
+  /**
+   * @param log The interaction log
+   * @param name The name of the method in `log`
+   */
+  Replay(std::shared_ptr<MappedLog> log, std::string name);
+
+  detail::Production<Class, ReturnType> call(const Args&...) override;
+
+  /**
+   * Check if all records have been replayed.
+   */
+  bool is_exhausted() const;
+
+  /**
+   * Forward `1` to `counter` until all records have been replayed.
+   */
+  void track(std::shared_ptr<detail::Counter> counter);
+
+private:
+  void advance(std::size_t offset);
+
+  // The type of the replayed return value; a dummy if there is none.
+  using Result = std::conditional_t<
+      serializable and not std::is_void_v<DecayedReturnType>,
+      DecayedReturnType,
+      std::monostate
+    >;
+
+  std::shared_ptr<MappedLog> log_{};
+  std::string name_{};
+  std::optional<MappedLog::Record> next_{};  /**> The next record of the method, if any */
+  std::deque<Result> results_{};  /**> The replayed return values */
+  std::shared_ptr<detail::Counter> unsatisfied_{std::make_shared<detail::Counter>()};  /**> `1` if `next_` is set */
+};
+
+} // namespace drmock
+
+#include "Replay.tpp"
+
+#endif /* DRMOCK_SRC_DRMOCK_MOCK_REPLAY_H */
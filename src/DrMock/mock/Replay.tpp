@@ -0,0 +1,121 @@
+/* Copyright 2021 Ole Kliemann, Malte Kliemann
+ *
+ * This file is part of DrMock.
+ *
+ * DrMock is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DrMock is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DrMock.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include <cstdint>
+#include <stdexcept>
+#include <tuple>
+
+#include <DrMock/mock/detail/IsEqual.h>
+#include <DrMock/mock/detail/Outcome.h>
+
+namespace drmock {
+
+template<typename Class, typename ReturnType, typename... Args>
+Replay<Class, ReturnType, Args...>::Replay(std::shared_ptr<MappedLog> log, std::string name)
+:
+  log_{std::move(log)},
+  name_{std::move(name)}
+{
+  if constexpr (serializable)
+  {
+    advance(log_->begin());
+    if (next_)
+    {
+      unsatisfied_->add(1);
+    }
+  }
+}
+
+template<typename Class, typename ReturnType, typename... Args>
+detail::Production<Class, ReturnType>
+Replay<Class, ReturnType, Args...>::call(const Args&... args)
+{
+  if constexpr (not serializable)
+  {
+    return std::monostate{};
+  }
+  else
+  {
+    using drutility::detail::Serializer;
+
+    if (not next_)
+    {
+      return std::monostate{};
+    }
+
+    auto pos = next_->payload.data();
+    auto end = pos + next_->payload.size();
+    auto expected = Serializer<std::tuple<std::decay_t<Args>...>>::read(pos, end);
+    bool match = std::apply(
+        [&args...] (const auto&... xs) {
+            return (detail::IsEqual<std::decay_t<Args>>{}(xs, args) and ...);
+          },
+        expected
+      );
+    if (not match)
+    {
+      return std::monostate{};
+    }
+
+    // `pos` points into the log, so it remains valid after advancing.
+    advance(next_->next);
+    if (not next_)
+    {
+      unsatisfied_->add(-1);
+    }
+
+    auto outcome = static_cast<detail::Outcome>(Serializer<std::uint8_t>::read(pos, end));
+    if (outcome == detail::Outcome::exception)
+    {
+      auto what = Serializer<std::string>::read(pos, end);
+      return std::make_exception_ptr(std::runtime_error{what});
+    }
+    if constexpr (std::is_void_v<DecayedReturnType>)
+    {
+      return detail::ResultRef<Class, ReturnType>{nullptr, nullptr};
+    }
+    else
+    {
+      // Earlier results may still be referenced by the caller.
+      auto& result = results_.emplace_back(Serializer<DecayedReturnType>::read(pos, end));
+      return detail::ResultRef<Class, ReturnType>{&result, nullptr};
+    }
+  }
+}
+
+template<typename Class, typename ReturnType, typename... Args>
+bool
+Replay<Class, ReturnType, Args...>::is_exhausted() const
+{
+  return unsatisfied_->get() == 0;
+}
+
+template<typename Class, typename ReturnType, typename... Args>
+void
+Replay<Class, ReturnType, Args...>::track(std::shared_ptr<detail::Counter> counter)
+{
+  unsatisfied_->parent(std::move(counter));
+}
+
+template<typename Class, typename ReturnType, typename... Args>
+void
+Replay<Class, ReturnType, Args...>::advance(std::size_t offset)
+{
+  next_ = log_->find(name_, offset);
+}
+
+} // namespace drmock
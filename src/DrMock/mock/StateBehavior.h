@@ -19,15 +19,18 @@
 #ifndef DRMOCK_SRC_DRMOCK_MOCK_STATEBEHAVIOR_H
 #define DRMOCK_SRC_DRMOCK_MOCK_STATEBEHAVIOR_H
 
+#include <cstddef>
 #include <exception>
-#include <map>
+#include <limits>
 #include <memory>
 #include <variant>
+#include <vector>
 
 #include <DrMock/mock/detail/IMakeTupleOfMatchers.h>
 #include <DrMock/mock/AbstractBehavior.h>
 #include <DrMock/mock/detail/MatchPack.h>
 #include <DrMock/mock/StateObject.h>
+#include <DrMock/mock/StaticMatchers.h>
 
 namespace drmock {
 
@@ -82,6 +85,11 @@ namespace drmock {
  * `(current_state, input...)` matches multiple entries of the transition
  * table with the same slot (this depends on the `matcher`). If this is
  * the case, the transition that is executed is undefined.
+ *
+ * The names of slots and states are interned by the `StateObject` when
+ * the behavior is configured, and the transition and result tables are
+ * stored as arrays indexed by state ID. Thus, `call` doesn't compare or
+ * copy any strings.
  */
 template<typename Class, typename ReturnType, typename... Args>
 class StateBehavior final : public AbstractBehavior<Class, ReturnType, Args...>
@@ -184,6 +192,46 @@ public:
       detail::Expect<Args>... input
     );
 
+  /**
+   * Add a transition for the default slot with static matchers.
+   *
+   * Is equivalent to
+   * `transition_static("", current_state, new_state, matchers...)`.
+   */
+  template<typename... Matchers>
+  std::enable_if_t<
+      (sizeof...(Matchers) == sizeof...(Args))
+        and (detail::is_static_matcher_v<Matchers> and ...),
+      StateBehavior&
+    > transition_static(
+      const std::string& current_state,
+      std::string new_state,
+      Matchers&&... matchers
+    );
+  /**
+   * Add a transition with static matchers.
+   *
+   * @param slot The slot for which the transition holds
+   * @param current_state The state to transition from
+   * @param new_state The state to transition to
+   * @param matchers... The static matchers (`eq`, `almost` or `any`),
+   *   one for each parameter
+   *
+   * Like `transition`, but the matchers are stored by value (see
+   * `Behavior::expects_static`).
+   */
+  template<typename... Matchers>
+  std::enable_if_t<
+      (sizeof...(Matchers) == sizeof...(Args))
+        and (detail::is_static_matcher_v<Matchers> and ...),
+      StateBehavior&
+    > transition_static(
+      const std::string& slot,
+      const std::string& current_state,
+      std::string new_state,
+      Matchers&&... matchers
+    );
+
   /**
    * Set a return value for a state on the default slot.
    *
@@ -314,12 +362,13 @@ public:
    *     statement for the wildcard state `"*"` exists and, if so,
    *     return the result.
    *   + Otherwise, return `std::monotstate{}`
+   *
+   * Once `this` is configured, `call` may be called from multiple
+   * threads. Every slot is transitioned atomically (see
+   * `StateObject::transition`), and the result is taken from the
+   * state the call transitioned the result slot to.
    */
-  virtual std::variant<
-      std::monostate,
-      Result,
-      std::exception_ptr
-    > call(const Args&... args) override;
+  virtual detail::Production<Class, ReturnType> call(const Args&... args) override;
 
 private:
   // Set the result slot if not already set. Throw if the result slot is
@@ -328,8 +377,17 @@ private:
   void setResultSlot(const std::string& slot);
   bool fix_result_slot_{false};  // Remember if result slot is set.
 
+  // Return a view of the entry `result` of the result table.
+  static detail::Production<Class, ReturnType> view(
+      const std::variant<std::monostate, Result, std::exception_ptr>& result
+    );
+
+  // Return the entry of the result table for `state_id`, resizing the
+  // table if necessary.
+  std::variant<std::monostate, Result, std::exception_ptr>& result(std::size_t state_id);
+
   void updateResultSlot(
-      const std::string& state,
+      std::size_t state_id,
       std::shared_ptr<std::decay_t<ReturnType>> rtn,
       std::shared_ptr<AbstractSignal<Class>> signal
     );
@@ -343,24 +401,49 @@ private:
       detail::Expect<Args>... input
     );
 
+  // Transition table entry of a slot.
+  struct Transition
+  {
+    std::tuple<std::shared_ptr<IMatcher<Args>>...> input;
+    detail::StaticMatch<Args...> static_input;  // Used instead of `input` if set.
+    std::size_t target;  // The state ID to transition to.
+  };
+  // Add `t` to the transition table.
+  StateBehavior& addTransition(
+      const std::string& slot,
+      const std::string& current_state,
+      const std::string& new_state,
+      Transition t
+    );
+  struct SlotTransitions
+  {
+    std::size_t slot_id;
+    std::vector<std::vector<Transition>> table;  // state ID -> { (input, target) }
+  };
+
+  // Return the target state ID of the first entry of `table[state_id]`
+  // that matches `args...`, or `npos`.
+  std::size_t findTransition(
+      const std::vector<std::vector<Transition>>& table,
+      std::size_t state_id,
+      const Args&... args
+    ) const;
+
+  static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
   std::shared_ptr<StateObject> state_object_;
   std::shared_ptr<detail::IMakeTupleOfMatchers<Args...>> make_tuple_of_matchers_{};
   std::string slot_{};
-  std::map<
-      std::string,
+  std::size_t slot_id_ = 0;  // ID of `slot_`
+  std::size_t wildcard_id_;  // ID of the state `"*"`
+  std::vector<
       std::variant<
           std::monostate,
           Result,
           std::exception_ptr
         >
-    > results_{};
-  std::map<
-      std::string,
-      std::map<
-          std::string,
-          std::vector<std::pair<std::tuple<std::shared_ptr<IMatcher<Args>>...>, std::string>>
-        >
-    > transitions_{};  // slot -> { state -> { (input, target) } }
+    > results_{};  // state ID -> result, `std::monostate` if none is set
+  std::vector<SlotTransitions> transitions_{};
   detail::MatchPack<std::tuple<Args...>> match_pack_{};
 };
 
@@ -16,6 +16,8 @@
  * along with DrMock.  If not, see <https://www.gnu.org/licenses/>.
 */
 
+#include <algorithm>
+
 #include <DrMock/mock/detail/MakeTupleOfMatchers.h>
 #include <DrMock/mock/Signal.h>
 
@@ -37,7 +39,7 @@ StateBehavior<Class, ReturnType, Args...>::StateBehavior(
 :
   StateBehavior{
       state_object,
-      std::make_shared<detail::MakeTupleOfMatchers<std::tuple<Args...>>>()
+      std::make_shared<detail::MakeTupleOfMatchers<std::tuple<Args...>>>(state_object->arena())
     }
 {}
 
@@ -48,7 +50,8 @@ StateBehavior<Class, ReturnType, Args...>::StateBehavior(
   )
 :
   state_object_{state_object},
-  make_tuple_of_matchers_{make_tuple_of_matchers}
+  make_tuple_of_matchers_{make_tuple_of_matchers},
+  wildcard_id_{state_object_->stateId("*")}
 {}
 
 template<typename Class, typename ReturnType, typename... Args>
@@ -118,7 +121,9 @@ StateBehavior<Class, ReturnType, Args...>::transition(
       "Specified impossible polymorphic setting"
     );
   return transition(
-      std::make_shared<detail::MakeTupleOfMatchers<std::tuple<Args...>, std::tuple<Deriveds...>>>(),
+      std::make_shared<detail::MakeTupleOfMatchers<std::tuple<Args...>, std::tuple<Deriveds...>>>(
+          state_object_->arena()
+        ),
       slot,
       current_state,
       std::move(new_state),
@@ -138,7 +143,7 @@ StateBehavior<Class, ReturnType, Args...>::polymorphic()
   make_tuple_of_matchers_ = std::make_shared<detail::MakeTupleOfMatchers<
       std::tuple<Args...>,
       std::tuple<Deriveds...>
-    >>();
+    >>(state_object_->arena());
   return *this;
 }
 
@@ -164,9 +169,12 @@ StateBehavior<Class, ReturnType, Args...>::returns(
   )
 {
   setResultSlot(slot);
-  auto return_ptr = std::make_shared<std::decay_t<ReturnType>>(std::forward<T>(value));
+  auto return_ptr = detail::allocateShared<std::decay_t<ReturnType>>(
+      state_object_->arena(),
+      std::forward<T>(value)
+    );
   auto signal_ptr = nullptr;
-  updateResultSlot(state, return_ptr, signal_ptr);
+  updateResultSlot(state_object_->stateId(state), return_ptr, signal_ptr);
   return *this;
 }
 
@@ -194,7 +202,8 @@ StateBehavior<Class, ReturnType, Args...>::throws(
   setResultSlot(slot);
 
   // Check if a result is already set for `state`.
-  if (results_.find(state) != results_.end())
+  auto& entry = result(state_object_->stateId(state));
+  if (not std::holds_alternative<std::monostate>(entry))
   {
       throw std::runtime_error{
           "Result already set for state '" + state + "'. Please check your mock object"
@@ -202,8 +211,7 @@ StateBehavior<Class, ReturnType, Args...>::throws(
         };
   }
 
-  auto ptr = std::make_exception_ptr(excp);
-  results_[state] = std::move(ptr);
+  entry = std::make_exception_ptr(excp);
   return *this;
 }
 
@@ -232,101 +240,94 @@ StateBehavior<Class, ReturnType, Args...>::emits(
 {
   setResultSlot(slot);
   auto return_ptr = nullptr;
-  auto signal_ptr = std::make_shared<Signal<Class, SigArgs...>>(
+  auto signal_ptr = detail::allocateShared<Signal<Class, SigArgs...>>(
+      state_object_->arena(),
       signal,
       std::forward<SigArgs>(args)...
     );
-  updateResultSlot(state, return_ptr, signal_ptr);
+  updateResultSlot(state_object_->stateId(state), return_ptr, signal_ptr);
   return *this;
 }
 
 template<typename Class, typename ReturnType, typename... Args>
-std::variant<
-    std::monostate,
-    std::pair<
-        std::shared_ptr<std::decay_t<ReturnType>>,
-        std::shared_ptr<AbstractSignal<Class>>
-      >,
-    std::exception_ptr
-  >
+detail::Production<Class, ReturnType>
 StateBehavior<Class, ReturnType, Args...>::call(const Args&... args)
 {
-  // Transition all slots.
+  // Transition all slots. A matching transition from the current state
+  // takes precedence over a matching wildcard transition. The state is
+  // changed only if it's still the state the transition was chosen
+  // for, otherwise the transition is chosen again, so that concurrent
+  // calls transition the slot one after the other.
+  auto state = npos;  // The state of the result slot after transition.
   for (const auto& v : transitions_)
   {
-    // Get current_state and transition table.
-    std::string slot = v.first;
-    std::string current_state = state_object_->get(slot);
-    auto& map = v.second;  // state -> { (input..., target) }
-
-    // ReturnTypes.
-    bool found_match{false};
-    std::string new_state;
-
-    // Find a match. Search the wildcard (fallthrough) transitions
-    // first, then look for a direct match.
-    if (map.find("*") != map.end())
+    auto current_state = state_object_->getState(v.slot_id);
+    auto new_state = npos;
+    while (true)
     {
-      auto& vec = map.at("*");  // { (input..., target) }
-      for (const auto& p : vec)
+      new_state = findTransition(v.table, current_state, args...);
+      if (new_state == npos)
       {
-        if ( match_pack_(p.first, args...) )
-        {
-          new_state = p.second;
-          found_match = true;
-          break;
-        }
+        new_state = findTransition(v.table, wildcard_id_, args...);
       }
-    }
-    if (map.find(current_state) != map.end())
-    {
-      auto& vec = map.at(current_state);  // { (input..., target) }
-      for (const auto& p : vec)
+      if (new_state == npos or state_object_->transition(v.slot_id, current_state, new_state))
       {
-        if ( match_pack_(p.first, args...) )
-        {
-          new_state = p.second;
-          found_match = true;
-          break;
-        }
+        break;
       }
+      current_state = state_object_->getState(v.slot_id);
     }
 
-    // Execute the transition.
-    if (found_match)
+    if (v.slot_id == slot_id_)
     {
-      state_object_->set(slot, new_state);
+      state = (new_state == npos) ? current_state : new_state;
     }
   }
 
-  // Get the slot's new state.
-  auto state = state_object_->get(slot_);
-
-  // Return the result if possible.
-  if (results_.find(state) != results_.end())
+  // Get the slot's new state (if the result slot has no transitions).
+  if (state == npos)
   {
-    return results_[state];
+    state = state_object_->getState(slot_id_);
   }
 
-  // If no direct result is found, check for a wildcard.
-  if (results_.find("*") != results_.end())
+  // Return the result if possible. If no direct result is found,
+  // check for a wildcard.
+  if (state < results_.size() and not std::holds_alternative<std::monostate>(results_[state]))
   {
-    return results_["*"];
+    return view(results_[state]);
+  }
+  if (wildcard_id_ < results_.size() and not std::holds_alternative<std::monostate>(results_[wildcard_id_]))
+  {
+    return view(results_[wildcard_id_]);
   }
 
   // If no result was found, but the function is void, return void.
   if constexpr (std::is_same<std::decay_t<ReturnType>, void>::value)
   {
-    return std::pair<
-        std::shared_ptr<void>,
-        std::shared_ptr<AbstractSignal<Class>>
-      >{{}, {}};
+    return detail::ResultRef<Class, ReturnType>{nullptr, nullptr};
   }
 
   // Otherwise, return nothing.
   return std::monostate{};
 }
 
+template<typename Class, typename ReturnType, typename... Args>
+detail::Production<Class, ReturnType>
+StateBehavior<Class, ReturnType, Args...>::view(
+    const std::variant<std::monostate, Result, std::exception_ptr>& result
+  )
+{
+  if (std::holds_alternative<Result>(result))
+  {
+    const auto& p = std::get<Result>(result);
+    return detail::ResultRef<Class, ReturnType>{p.first.get(), p.second.get()};
+  }
+  else if (std::holds_alternative<std::exception_ptr>(result))
+  {
+    return std::get<std::exception_ptr>(result);
+  }
+  return std::monostate{};
+}
+
 template<typename Class, typename ReturnType, typename... Args>
 void
 StateBehavior<Class, ReturnType, Args...>::setResultSlot(const std::string& slot)
@@ -335,6 +336,7 @@ StateBehavior<Class, ReturnType, Args...>::setResultSlot(const std::string& slot
   {
     fix_result_slot_ = true;
     slot_ = slot;
+    slot_id_ = state_object_->slotId(slot_);
   }
   else if (slot_ != slot)
   {
@@ -345,33 +347,34 @@ StateBehavior<Class, ReturnType, Args...>::setResultSlot(const std::string& slot
 template<typename Class, typename ReturnType, typename... Args>
 void
 StateBehavior<Class, ReturnType, Args...>::updateResultSlot(
-    const std::string& state,
+    std::size_t state_id,
     std::shared_ptr<std::decay_t<ReturnType>> return_ptr,
     std::shared_ptr<AbstractSignal<Class>> signal_ptr
   )
 {
-  auto it = results_.find(state);
+  auto& entry = result(state_id);
+  const auto& state = state_object_->stateName(state_id);
 
   // If no result is registered for `state`, create one.
-  if (it == results_.end())
+  if (std::holds_alternative<std::monostate>(entry))
   {
-    results_[state] = Result{std::move(return_ptr), std::move(signal_ptr)};
+    entry = Result{std::move(return_ptr), std::move(signal_ptr)};
     return;
   }
 
   // If there is a result, but it's not a return/emit, raise an error.
-  if (not std::holds_alternative<Result>(it->second))
+  if (not std::holds_alternative<Result>(entry))
   {
     throw std::runtime_error{
         "Monostate/throw result already set for state '" + state + "'. Please check your mock"
         " object configuration."
       };
   }
-  auto result = std::get<Result>(it->second);
+  auto current = std::get<Result>(entry);
 
   // If the result is return/emit with non-null return, throw instead of
   // overwriting the return. Otherwise, re-use the return value.
-  if (result.first != nullptr)
+  if (current.first != nullptr)
   {
     if (return_ptr != nullptr)
     {
@@ -380,12 +383,12 @@ StateBehavior<Class, ReturnType, Args...>::updateResultSlot(
           " configuration."
         };
     }
-    return_ptr = result.first;
+    return_ptr = current.first;
   }
 
   // If the result is return/emit with non-null emit, throw instead of
   // overwriting the emit.
-  if (result.second != nullptr)
+  if (current.second != nullptr)
   {
     if (signal_ptr != nullptr)
     {
@@ -394,12 +397,48 @@ StateBehavior<Class, ReturnType, Args...>::updateResultSlot(
           " configuration."
         };
     }
-    signal_ptr = result.second;
+    signal_ptr = current.second;
   }
 
   // If none of this is true, set the return result, but don't delete
   // the emit result in the process!
-  results_[state] = Result{return_ptr, signal_ptr};
+  entry = Result{return_ptr, signal_ptr};
+}
+
+template<typename Class, typename ReturnType, typename... Args>
+std::variant<
+    std::monostate,
+    typename StateBehavior<Class, ReturnType, Args...>::Result,
+    std::exception_ptr
+  >&
+StateBehavior<Class, ReturnType, Args...>::result(std::size_t state_id)
+{
+  if (state_id >= results_.size())
+  {
+    results_.resize(state_id + 1);
+  }
+  return results_[state_id];
+}
+
+template<typename Class, typename ReturnType, typename... Args>
+std::size_t
+StateBehavior<Class, ReturnType, Args...>::findTransition(
+    const std::vector<std::vector<Transition>>& table,
+    std::size_t state_id,
+    const Args&... args
+  ) const
+{
+  if (state_id < table.size())
+  {
+    for (const auto& t : table[state_id])
+    {
+      if (t.static_input ? t.static_input(args...) : match_pack_(t.input, args...))
+      {
+        return t.target;
+      }
+    }
+  }
+  return npos;
 }
 
 template<typename Class, typename ReturnType, typename... Args>
@@ -411,6 +450,66 @@ StateBehavior<Class, ReturnType, Args...>::transition(
     std::string new_state,
     detail::Expect<Args>... input
   )
+{
+  return addTransition(
+      slot,
+      current_state,
+      new_state,
+      Transition{make_tuple_of_matchers->wrap(std::move(input)...), {}, 0}
+    );
+}
+
+template<typename Class, typename ReturnType, typename... Args>
+template<typename... Matchers>
+std::enable_if_t<
+    (sizeof...(Matchers) == sizeof...(Args))
+      and (detail::is_static_matcher_v<Matchers> and ...),
+    StateBehavior<Class, ReturnType, Args...>&
+  >
+StateBehavior<Class, ReturnType, Args...>::transition_static(
+    const std::string& current_state,
+    std::string new_state,
+    Matchers&&... matchers
+  )
+{
+  return transition_static(
+      "",
+      current_state,
+      std::move(new_state),
+      std::forward<Matchers>(matchers)...
+    );
+}
+
+template<typename Class, typename ReturnType, typename... Args>
+template<typename... Matchers>
+std::enable_if_t<
+    (sizeof...(Matchers) == sizeof...(Args))
+      and (detail::is_static_matcher_v<Matchers> and ...),
+    StateBehavior<Class, ReturnType, Args...>&
+  >
+StateBehavior<Class, ReturnType, Args...>::transition_static(
+    const std::string& slot,
+    const std::string& current_state,
+    std::string new_state,
+    Matchers&&... matchers
+  )
+{
+  return addTransition(
+      slot,
+      current_state,
+      new_state,
+      Transition{{}, detail::makeStaticMatch<Args...>(std::forward<Matchers>(matchers)...), 0}
+    );
+}
+
+template<typename Class, typename ReturnType, typename... Args>
+StateBehavior<Class, ReturnType, Args...>&
+StateBehavior<Class, ReturnType, Args...>::addTransition(
+    const std::string& slot,
+    const std::string& current_state,
+    const std::string& new_state,
+    Transition t
+  )
 {
   // Throw if the new_state is the wildcard symbol `"*"`.
   if (new_state == "*")
@@ -419,11 +518,24 @@ StateBehavior<Class, ReturnType, Args...>::transition(
   }
 
   // Register the slot in the `StateObject`.
-  state_object_->get(slot);
+  auto slot_id = state_object_->slotId(slot);
+  auto state_id = state_object_->stateId(current_state);
 
   // Get the transitions for this slot.
-  auto& map = transitions_[slot];  // state -> { (input..., target ) }
-  auto& vec = map[current_state];  // { (input..., target) }
+  auto it = std::find_if(
+      transitions_.begin(), transitions_.end(),
+      [slot_id] (const auto& v) { return v.slot_id == slot_id; }
+    );
+  if (it == transitions_.end())
+  {
+    it = transitions_.insert(transitions_.end(), SlotTransitions{slot_id, {}});
+  }
+  auto& table = it->table;  // state ID -> { (input..., target) }
+  if (state_id >= table.size())
+  {
+    table.resize(state_id + 1);
+  }
+  auto& vec = table[state_id];  // { (input..., target) }
 
   // // Check for conflicts... A conflict arises if there are two
   // // transitions that match the same (slot, current_state, input...).
@@ -436,12 +548,8 @@ StateBehavior<Class, ReturnType, Args...>::transition(
   // }
 
   // If all checks out, add the transition.
-  vec.push_back(
-      std::make_pair(
-          make_tuple_of_matchers->wrap(std::move(input)...),
-          std::move(new_state)
-        )
-    );
+  t.target = state_object_->stateId(new_state);
+  vec.push_back(std::move(t));
   return *this;
 }
 
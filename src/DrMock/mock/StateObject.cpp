@@ -15,27 +15,39 @@
  * You should have received a copy of the GNU General Public License
  * along with DrMock.  If not, see <https://www.gnu.org/licenses/>.
 */
-
 #include "StateObject.h"
 
 namespace drmock {
 
-std::string
+StateObject::StateObject()
+{
+  stateIdImpl("");
+  slotIdImpl("");
+}
+
+const std::string&
 StateObject::get(const std::string& slot)
 {
-  return slots_[slot];
+  return stateName(getState(slotId(slot)));
 }
 
-std::string
+const std::string&
 StateObject::get()
 {
-  return get("");
+  return stateName(getState(0));
 }
 
 void
 StateObject::set(const std::string& slot, std::string state)
 {
-  slots_[slot] = std::move(state);
+  std::size_t slot_id;
+  std::size_t state_id;
+  {
+    std::lock_guard<std::mutex> lock{mtx_};
+    slot_id = slotIdImpl(slot);
+    state_id = stateIdImpl(state);
+  }
+  setState(slot_id, state_id);
 }
 
 void
@@ -44,4 +56,89 @@ StateObject::set(std::string state)
   set("", std::move(state));
 }
 
+std::size_t
+StateObject::slotId(const std::string& slot)
+{
+  std::lock_guard<std::mutex> lock{mtx_};
+  return slotIdImpl(slot);
+}
+
+std::size_t
+StateObject::stateId(const std::string& state)
+{
+  std::lock_guard<std::mutex> lock{mtx_};
+  return stateIdImpl(state);
+}
+
+const std::string&
+StateObject::stateName(std::size_t state_id) const
+{
+  return state_names_[state_id];
+}
+
+std::size_t
+StateObject::getState(std::size_t slot_id) const
+{
+  return states_[slot_id].load(std::memory_order_acquire);
+}
+
+void
+StateObject::setState(std::size_t slot_id, std::size_t state_id)
+{
+  states_[slot_id].store(state_id, std::memory_order_release);
+}
+
+bool
+StateObject::transition(
+    std::size_t slot_id,
+    std::size_t current_state_id,
+    std::size_t new_state_id
+  )
+{
+  return states_[slot_id].compare_exchange_strong(
+      current_state_id,
+      new_state_id,
+      std::memory_order_acq_rel
+    );
+}
+
+std::size_t
+StateObject::slotIdImpl(const std::string& slot)
+{
+  auto it = slot_ids_.find(slot);
+  if (it != slot_ids_.end())
+  {
+    return it->second;
+  }
+  auto slot_id = states_.grow();  // Value-initialized to state "".
+  slot_ids_.emplace(slot, slot_id);
+  return slot_id;
+}
+
+std::size_t
+StateObject::stateIdImpl(const std::string& state)
+{
+  auto it = state_ids_.find(state);
+  if (it != state_ids_.end())
+  {
+    return it->second;
+  }
+  auto state_id = state_names_.grow();
+  state_names_[state_id] = state;
+  state_ids_.emplace(state, state_id);
+  return state_id;
+}
+
+const std::shared_ptr<detail::Arena>&
+StateObject::arena() const
+{
+  return arena_;
+}
+
+void
+StateObject::renewArena()
+{
+  arena_ = std::make_shared<detail::Arena>();
+}
+
 } // namespace drmock
@@ -19,9 +19,16 @@
 #ifndef DRMOCK_SRC_DRMOCK_MOCK_STATEOBJECT_H
 #define DRMOCK_SRC_DRMOCK_MOCK_STATEOBJECT_H
 
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 
+#include <DrMock/mock/detail/Arena.h>
+#include <DrMock/mock/detail/SegmentedVector.h>
+
 namespace drmock {
 
 /**
@@ -31,21 +38,38 @@ namespace drmock {
  * `std::string`). Slots that are stored in the StateObject are called
  * _registered_. During construction, the _default slot_ `""` is
  * registered with state `""`.
+ *
+ * Slot and state names are _interned_: Every slot and state is
+ * assigned a small integer ID when it is first used. `StateBehavior`
+ * resolves the names of its configuration to IDs once, so that calls
+ * only compare integers.
+ *
+ * All methods are thread-safe. The state of every slot is an atomic
+ * state ID, so reading and writing states by ID takes no locks and
+ * `transition` allows to atomically change the state of a slot.
+ * Registering slots and states and looking them up by name is
+ * synchronized by a mutex. Reading a state never allocates.
+ *
+ * The StateObject shared by the methods of a mock also owns the arena
+ * from which their behaviors, matchers, return values and signals are
+ * allocated (see `arena`).
  */
 class StateObject
 {
 public:
+  StateObject();
+
   /**
    * Get the state of `slot`.
    * 
    * If `slot` is not registered yet, it is registered with state `""`
    * before returning `""`.
    */
-  std::string get(const std::string& slot);
+  const std::string& get(const std::string& slot);
   /**
    * Get the state of the default slot.
    */
-  std::string get();
+  const std::string& get();
 
   /**
    * Set the state of `slot` to `state`.
@@ -56,8 +80,69 @@ public:
    */
   void set(std::string state);
 
+  /**
+   * Get the ID of `slot`.
+   *
+   * If `slot` is not registered yet, it is registered with state `""`.
+   * The default slot has ID 0.
+   */
+  std::size_t slotId(const std::string& slot);
+  /**
+   * Get the ID of `state`.
+   *
+   * The state `""` has ID 0.
+   */
+  std::size_t stateId(const std::string& state);
+  /**
+   * Get the name of the state with ID `state_id`.
+   */
+  const std::string& stateName(std::size_t state_id) const;
+
+  /**
+   * Get the ID of the state of the slot with ID `slot_id`.
+   */
+  std::size_t getState(std::size_t slot_id) const;
+  /**
+   * Set the state of the slot with ID `slot_id` to the state with ID
+   * `state_id`.
+   */
+  void setState(std::size_t slot_id, std::size_t state_id);
+  /**
+   * Atomically set the state of the slot with ID `slot_id` to
+   * `new_state_id` if its current state is `current_state_id`.
+   *
+   * @returns `true` if the state was changed, otherwise `false`
+   */
+  bool transition(
+      std::size_t slot_id,
+      std::size_t current_state_id,
+      std::size_t new_state_id
+    );
+
+  /**
+   * Get the arena of the mock (see `detail::Arena`).
+   */
+  const std::shared_ptr<detail::Arena>& arena() const;
+  /**
+   * Replace the arena with a new one. The old arena is destroyed once
+   * nothing allocated from it remains.
+   *
+   * Must not be called while the methods sharing `this` are called or
+   * configured.
+   */
+  void renewArena();
+
 private:
-  std::unordered_map<std::string, std::string> slots_{};  // map: slot -> state
+  // Unsynchronized implementations of `slotId` and `stateId`.
+  std::size_t slotIdImpl(const std::string& slot);
+  std::size_t stateIdImpl(const std::string& state);
+
+  std::mutex mtx_{};  // Guards `slot_ids_`, `state_ids_` and growing the vectors.
+  std::unordered_map<std::string, std::size_t> slot_ids_{};  // map: slot -> slot ID
+  std::unordered_map<std::string, std::size_t> state_ids_{};  // map: state -> state ID
+  detail::SegmentedVector<std::string> state_names_{};  // state ID -> state
+  detail::SegmentedVector<std::atomic<std::size_t>> states_{};  // slot ID -> state ID
+  std::shared_ptr<detail::Arena> arena_{std::make_shared<detail::Arena>()};
 };
 
 } // namespace drmock
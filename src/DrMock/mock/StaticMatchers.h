@@ -0,0 +1,366 @@
+/* Copyright 2021 Ole Kliemann, Malte Kliemann
+ *
+ * This file is part of DrMock.
+ *
+ * DrMock is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DrMock is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DrMock.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef DRMOCK_SRC_DRMOCK_MOCK_STATICMATCHERS_H
+#define DRMOCK_SRC_DRMOCK_MOCK_STATICMATCHERS_H
+
+#include <cstddef>
+#include <new>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include <DrMock/mock/detail/Hash.h>
+#include <DrMock/mock/detail/IsEqual.h>
+#include <DrMock/utility/Compare.h>
+
+namespace drmock {
+
+namespace detail {
+
+// Base of all static matchers. A static matcher `m` is bound to the
+// parameter type `Arg` by `std::move(m).template bind<Arg>()`, which
+// returns an object with a non-virtual `bool operator()(const Arg&)`.
+struct StaticMatcher {};
+
+template<typename T>
+inline constexpr bool is_static_matcher_v = std::is_base_of_v<StaticMatcher, std::decay_t<T>>;
+
+template<typename Arg>
+struct BoundEq
+{
+  bool operator()(const Arg& actual) const
+  {
+    return IsEqual<Arg>{}(expected, actual);
+  }
+
+  Arg expected;
+};
+
+template<typename T>
+class Eq : public StaticMatcher
+{
+public:
+  Eq(T expected)
+  :
+    expected_{std::move(expected)}
+  {}
+
+  template<typename Arg>
+  BoundEq<Arg>
+  bind() &&
+  {
+    return BoundEq<Arg>{Arg(std::move(expected_))};
+  }
+
+private:
+  T expected_;
+};
+
+template<typename Arg>
+struct BoundAlmost
+{
+  bool operator()(const Arg& actual) const
+  {
+    return drutility::almost_equal(actual, expected, abs_tol, rel_tol);
+  }
+
+  Arg expected;
+  Arg abs_tol;
+  Arg rel_tol;
+};
+
+template<typename T>
+class Almost : public StaticMatcher
+{
+public:
+  Almost(T expected, T abs_tol, T rel_tol)
+  :
+    expected_{expected}, abs_tol_{abs_tol}, rel_tol_{rel_tol}
+  {}
+
+  template<typename Arg>
+  BoundAlmost<Arg>
+  bind() &&
+  {
+    static_assert(std::is_floating_point_v<Arg>, "almost() requires floating-point parameter");
+    return BoundAlmost<Arg>{
+        static_cast<Arg>(expected_),
+        static_cast<Arg>(abs_tol_),
+        static_cast<Arg>(rel_tol_)
+      };
+  }
+
+private:
+  T expected_;
+  T abs_tol_;
+  T rel_tol_;
+};
+
+struct BoundAny
+{
+  template<typename Arg>
+  bool operator()(const Arg&) const
+  {
+    return true;
+  }
+};
+
+class Any : public StaticMatcher
+{
+public:
+  template<typename Arg>
+  BoundAny
+  bind() &&
+  {
+    return {};
+  }
+};
+
+template<typename T>
+struct is_bound_eq : std::false_type {};
+
+template<typename Arg>
+struct is_bound_eq<BoundEq<Arg>> : std::true_type {};
+
+template<typename Tuple, typename... Args, std::size_t... Is>
+bool
+matchStatic(const Tuple& matchers, std::index_sequence<Is...>, const Args&... args)
+{
+  return (std::get<Is>(matchers)(args) and ...);
+}
+
+// Type-erased matcher for the parameters `Args...`, made of static
+// matchers bound to `Args...`.
+//
+// The bound matchers are stored in a buffer of `capacity` bytes (or on
+// the heap if they don't fit), so that configuring a behavior takes no
+// allocation and matching a call takes a single indirect call.
+template<typename... Args>
+class StaticMatch
+{
+public:
+  static constexpr std::size_t capacity = 64;
+
+  StaticMatch() = default;
+  // `hash` is the hash of the expected input (see `Behavior::hash`).
+  template<typename Tuple, typename = std::enable_if_t<drutility::detail::is_tuple<Tuple>::value>>
+  StaticMatch(Tuple matchers, std::optional<std::size_t> hash)
+  :
+    hash_{hash}
+  {
+    if constexpr (fits_inline_v<Tuple>)
+    {
+      new (buffer_) Tuple(std::move(matchers));
+    }
+    else
+    {
+      new (buffer_) Tuple*(new Tuple(std::move(matchers)));
+    }
+    ops_ = ops<Tuple>();
+  }
+
+  StaticMatch(const StaticMatch& other)
+  {
+    *this = other;
+  }
+
+  StaticMatch&
+  operator=(const StaticMatch& other)
+  {
+    if (this != &other)
+    {
+      reset();
+      if (other.ops_)
+      {
+        other.ops_->copy(buffer_, other.buffer_);
+        ops_ = other.ops_;
+      }
+      hash_ = other.hash_;
+    }
+    return *this;
+  }
+
+  ~StaticMatch()
+  {
+    reset();
+  }
+
+  explicit operator bool() const
+  {
+    return ops_ != nullptr;
+  }
+
+  bool operator()(const Args&... args) const
+  {
+    return ops_->match(buffer_, args...);
+  }
+
+  std::optional<std::size_t> hash() const
+  {
+    return hash_;
+  }
+
+private:
+  struct Ops
+  {
+    bool (*match)(const void*, const Args&...);
+    void (*copy)(void*, const void*);
+    void (*destroy)(void*);
+  };
+
+  template<typename Tuple>
+  static constexpr bool fits_inline_v = (sizeof(Tuple) <= capacity)
+      and (alignof(Tuple) <= alignof(std::max_align_t));
+
+  // Return the operations on a buffer which holds a `Tuple`, or a
+  // pointer to a `Tuple` if it doesn't fit into the buffer.
+  template<typename Tuple>
+  static const Ops*
+  ops()
+  {
+    if constexpr (fits_inline_v<Tuple>)
+    {
+      static constexpr Ops result{
+          [] (const void* p, const Args&... args) {
+            auto tuple = std::launder(static_cast<const Tuple*>(p));
+            return matchStatic(*tuple, std::index_sequence_for<Args...>{}, args...);
+          },
+          [] (void* dst, const void* src) {
+            new (dst) Tuple(*std::launder(static_cast<const Tuple*>(src)));
+          },
+          [] (void* p) { std::launder(static_cast<Tuple*>(p))->~Tuple(); }
+        };
+      return &result;
+    }
+    else
+    {
+      static constexpr Ops result{
+          [] (const void* p, const Args&... args) {
+            auto tuple = *std::launder(static_cast<Tuple* const*>(p));
+            return matchStatic(*tuple, std::index_sequence_for<Args...>{}, args...);
+          },
+          [] (void* dst, const void* src) {
+            new (dst) Tuple*(new Tuple(**std::launder(static_cast<Tuple* const*>(src))));
+          },
+          [] (void* p) { delete *std::launder(static_cast<Tuple**>(p)); }
+        };
+      return &result;
+    }
+  }
+
+  void reset()
+  {
+    if (ops_)
+    {
+      ops_->destroy(buffer_);
+      ops_ = nullptr;
+    }
+  }
+
+  const Ops* ops_ = nullptr;
+  std::optional<std::size_t> hash_{};
+  alignas(std::max_align_t) unsigned char buffer_[capacity];
+};
+
+// Return the hash of the input expected by `matchers` if they're all
+// `eq` of types which are hashable by equality, otherwise
+// `std::nullopt`.
+template<typename... Args, typename... Bound>
+std::optional<std::size_t>
+hashStatic(const std::tuple<Bound...>& matchers)
+{
+  if constexpr ((is_bound_eq<Bound>::value and ...)
+                and (is_hashable_by_equality_v<Args> and ...))
+  {
+    return std::apply(
+        [] (const Bound&... bound) { return hashAll(bound.expected...); },
+        matchers
+      );
+  }
+  else
+  {
+    return std::nullopt;
+  }
+}
+
+// Bind `matchers...` to `Args...` and store them by value in a
+// `StaticMatch<Args...>`.
+template<typename... Args, typename... Matchers>
+StaticMatch<Args...>
+makeStaticMatch(Matchers... matchers)
+{
+  static_assert(sizeof...(Args) == sizeof...(Matchers), "wrong number of matchers");
+  auto tuple = std::make_tuple(std::move(matchers).template bind<Args>()...);
+  auto hash = hashStatic<Args...>(tuple);
+  return {std::move(tuple), hash};
+}
+
+} // namespace detail
+
+/**
+ * Static matcher that matches by equality (see `Equal`).
+ *
+ * Unlike `equal`, the static matchers `eq`, `almost` and `any` are
+ * not wrapped in a `std::shared_ptr<IMatcher<T>>`. They are passed to
+ * `Behavior::expects_static` or `StateBehavior::transition_static`,
+ * which store them by value, so that matching a call takes no virtual
+ * call per argument and configuring takes no allocation per argument.
+ */
+template<typename T>
+detail::Eq<std::decay_t<T>>
+eq(T&& expected)
+{
+  return {std::forward<T>(expected)};
+}
+
+/**
+ * Static matcher that matches floating-point numbers approximately
+ * (see `AlmostEqual`) with the `DRTEST_*_TOL` default tolerances.
+ */
+template<typename T>
+detail::Almost<T>
+almost(T expected)
+{
+  return {expected, static_cast<T>(DRTEST_ABS_TOL), static_cast<T>(DRTEST_REL_TOL)};
+}
+
+/**
+ * Static matcher that matches floating-point numbers approximately
+ * (see `AlmostEqual`) with the specified tolerances.
+ */
+template<typename T>
+detail::Almost<T>
+almost(T expected, T abs_tol, T rel_tol)
+{
+  return {expected, abs_tol, rel_tol};
+}
+
+/**
+ * Static matcher that matches any input.
+ */
+inline detail::Any
+any()
+{
+  return {};
+}
+
+} // namespace drmock
+
+#endif /* DRMOCK_SRC_DRMOCK_MOCK_STATICMATCHERS_H */
@@ -0,0 +1,54 @@
+/* Copyright 2021 Ole Kliemann, Malte Kliemann
+ *
+ * This file is part of DrMock.
+ *
+ * DrMock is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DrMock is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DrMock.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "Arena.h"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace drmock { namespace detail {
+
+void*
+Arena::allocate(std::size_t size, std::size_t alignment)
+{
+  std::lock_guard<std::mutex> lck{mtx_};
+  auto padding = (alignment - reinterpret_cast<std::uintptr_t>(current_) % alignment) % alignment;
+  if (not current_ or padding + size > left_)
+  {
+    // Reserve enough memory to align the allocation in any case.
+    auto chunk_size = std::max(next_chunk_size_, size + alignment);
+    chunks_.emplace_back(new std::byte[chunk_size]);
+    current_ = chunks_.back().get();
+    left_ = chunk_size;
+    capacity_ += chunk_size;
+    next_chunk_size_ = std::min(2*next_chunk_size_, max_chunk_size);
+    padding = (alignment - reinterpret_cast<std::uintptr_t>(current_) % alignment) % alignment;
+  }
+  auto result = current_ + padding;
+  current_ += padding + size;
+  left_ -= padding + size;
+  return result;
+}
+
+std::size_t
+Arena::capacity() const
+{
+  std::lock_guard<std::mutex> lck{mtx_};
+  return capacity_;
+}
+
+}} // namespace drmock::detail
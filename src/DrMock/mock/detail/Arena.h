@@ -0,0 +1,116 @@
+/* Copyright 2021 Ole Kliemann, Malte Kliemann
+ *
+ * This file is part of DrMock.
+ *
+ * DrMock is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DrMock is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DrMock.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef DRMOCK_SRC_DRMOCK_MOCK_DETAIL_ARENA_H
+#define DRMOCK_SRC_DRMOCK_MOCK_DETAIL_ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+namespace drmock { namespace detail {
+
+/* Arena
+
+Monotonic allocator. Memory is taken from chunks of doubling size
+(starting at `initial_chunk_size`, up to `max_chunk_size`) and is only
+released in bulk when the arena is destroyed. `allocate` is thread-safe.
+
+Every mock owns an arena (see `StateObject::arena`) from which the
+behaviors, matchers, return values and signals of its methods are
+allocated using `ArenaAllocator`. As memory is not reused, a mock whose
+methods keep being configured grows until it is destroyed, or until
+the queues are cleared (see `Controller::clearQueues`), which moves the
+mock to a new arena. The old arena is destroyed once nothing allocated
+from it remains.
+*/
+
+class Arena
+{
+public:
+  Arena() = default;
+
+  Arena(const Arena&) = delete;
+  Arena& operator=(const Arena&) = delete;
+
+  void* allocate(std::size_t size, std::size_t alignment);
+  // Return the number of bytes taken from the system.
+  std::size_t capacity() const;
+
+private:
+  static constexpr std::size_t initial_chunk_size = 4096;
+  static constexpr std::size_t max_chunk_size = std::size_t{1} << 20;
+
+  mutable std::mutex mtx_{};
+  std::vector<std::unique_ptr<std::byte[]>> chunks_{};
+  std::byte* current_ = nullptr;  // Free memory of the last chunk
+  std::size_t left_ = 0;  // Size of the free memory of the last chunk
+  std::size_t next_chunk_size_ = initial_chunk_size;
+  std::size_t capacity_ = 0;
+};
+
+/* ArenaAllocator
+
+Allocator which allocates from a shared `Arena`, or from the heap if
+the arena is `nullptr`. Every allocation keeps the arena alive, so
+objects allocated with `std::allocate_shared` may outlive the mock that
+created them. Deallocation from an arena is a no-op.
+
+The allocator is propagated on move assignment, so that a container can
+be moved to another arena by assigning it an empty container.
+*/
+
+template<typename T>
+class ArenaAllocator
+{
+public:
+  using value_type = T;
+  using propagate_on_container_move_assignment = std::true_type;
+
+  ArenaAllocator() = default;
+  ArenaAllocator(std::shared_ptr<Arena> arena);
+  template<typename U> ArenaAllocator(const ArenaAllocator<U>& other);
+  // A moved-from allocator must still deallocate from the same arena,
+  // so moving is copying.
+  ArenaAllocator(const ArenaAllocator&) = default;
+  ArenaAllocator& operator=(const ArenaAllocator&) = default;
+
+  T* allocate(std::size_t n);
+  void deallocate(T* p, std::size_t n);
+
+  const std::shared_ptr<Arena>& arena() const;
+
+private:
+  std::shared_ptr<Arena> arena_{};
+};
+
+template<typename T, typename U>
+bool operator==(const ArenaAllocator<T>& lhs, const ArenaAllocator<U>& rhs);
+template<typename T, typename U>
+bool operator!=(const ArenaAllocator<T>& lhs, const ArenaAllocator<U>& rhs);
+
+// Shorthand for `std::allocate_shared<T>(ArenaAllocator<T>{arena}, ts...)`.
+template<typename T, typename... Ts>
+std::shared_ptr<T> allocateShared(const std::shared_ptr<Arena>& arena, Ts&&... ts);
+
+}} // namespace drmock::detail
+
+#include "Arena.tpp"
+
+#endif /* DRMOCK_SRC_DRMOCK_MOCK_DETAIL_ARENA_H */
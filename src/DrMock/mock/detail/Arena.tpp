@@ -0,0 +1,85 @@
+/* Copyright 2021 Ole Kliemann, Malte Kliemann
+ *
+ * This file is part of DrMock.
+ *
+ * DrMock is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DrMock is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DrMock.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <utility>
+
+namespace drmock { namespace detail {
+
+template<typename T>
+ArenaAllocator<T>::ArenaAllocator(std::shared_ptr<Arena> arena)
+:
+  arena_{std::move(arena)}
+{}
+
+template<typename T>
+template<typename U>
+ArenaAllocator<T>::ArenaAllocator(const ArenaAllocator<U>& other)
+:
+  arena_{other.arena()}
+{}
+
+template<typename T>
+T*
+ArenaAllocator<T>::allocate(std::size_t n)
+{
+  if (not arena_)
+  {
+    return std::allocator<T>{}.allocate(n);
+  }
+  return static_cast<T*>(arena_->allocate(n*sizeof(T), alignof(T)));
+}
+
+template<typename T>
+void
+ArenaAllocator<T>::deallocate(T* p, std::size_t n)
+{
+  if (not arena_)
+  {
+    std::allocator<T>{}.deallocate(p, n);
+  }
+}
+
+template<typename T>
+const std::shared_ptr<Arena>&
+ArenaAllocator<T>::arena() const
+{
+  return arena_;
+}
+
+template<typename T, typename U>
+bool
+operator==(const ArenaAllocator<T>& lhs, const ArenaAllocator<U>& rhs)
+{
+  return lhs.arena() == rhs.arena();
+}
+
+template<typename T, typename U>
+bool
+operator!=(const ArenaAllocator<T>& lhs, const ArenaAllocator<U>& rhs)
+{
+  return not (lhs == rhs);
+}
+
+template<typename T, typename... Ts>
+std::shared_ptr<T>
+allocateShared(const std::shared_ptr<Arena>& arena, Ts&&... ts)
+{
+  return std::allocate_shared<T>(ArenaAllocator<T>{arena}, std::forward<Ts>(ts)...);
+}
+
+}} // namespace drmock::detail
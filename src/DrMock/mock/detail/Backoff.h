@@ -0,0 +1,58 @@
+/* Copyright 2021 Ole Kliemann, Malte Kliemann
+ *
+ * This file is part of DrMock.
+ *
+ * DrMock is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DrMock is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DrMock.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef DRMOCK_SRC_DRMOCK_MOCK_DETAIL_BACKOFF_H
+#define DRMOCK_SRC_DRMOCK_MOCK_DETAIL_BACKOFF_H
+
+#include <thread>
+
+namespace drmock { namespace detail {
+
+/* Backoff
+
+Exponential backoff for retrying a failed compare-and-swap. Every call
+spins twice as long as the previous one; once `max_spins` is exceeded,
+the thread yields instead.
+*/
+
+class Backoff
+{
+public:
+  void operator()()
+  {
+    if (spins_ > max_spins)
+    {
+      std::this_thread::yield();
+      return;
+    }
+    for (unsigned int i = 0; i < spins_; ++i)
+    {
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+      __builtin_ia32_pause();
+#endif
+    }
+    spins_ *= 2;
+  }
+
+private:
+  static constexpr unsigned int max_spins = 64;
+  unsigned int spins_ = 1;
+};
+
+}} // namespace drmock::detail
+
+#endif /* DRMOCK_SRC_DRMOCK_MOCK_DETAIL_BACKOFF_H */
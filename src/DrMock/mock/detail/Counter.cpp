@@ -0,0 +1,65 @@
+/* Copyright 2021 Ole Kliemann, Malte Kliemann
+ *
+ * This file is part of DrMock.
+ *
+ * DrMock is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DrMock is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DrMock.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "Counter.h"
+
+namespace drmock { namespace detail {
+
+Counter::Counter(std::shared_ptr<Counter> parent)
+:
+  parent_{std::move(parent)}
+{}
+
+Counter::~Counter()
+{
+  if (parent_)
+  {
+    parent_->add(-get());
+  }
+}
+
+void
+Counter::add(std::ptrdiff_t n)
+{
+  for (auto counter = this; counter; counter = counter->parent_.get())
+  {
+    counter->value_.fetch_add(n, std::memory_order_relaxed);
+  }
+}
+
+std::ptrdiff_t
+Counter::get() const
+{
+  return value_.load(std::memory_order_relaxed);
+}
+
+void
+Counter::parent(std::shared_ptr<Counter> parent)
+{
+  auto value = get();
+  if (parent_)
+  {
+    parent_->add(-value);
+  }
+  parent_ = std::move(parent);
+  if (parent_)
+  {
+    parent_->add(value);
+  }
+}
+
+}} // namespace drmock::detail
@@ -0,0 +1,60 @@
+/* Copyright 2021 Ole Kliemann, Malte Kliemann
+ *
+ * This file is part of DrMock.
+ *
+ * DrMock is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DrMock is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DrMock.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef DRMOCK_SRC_DRMOCK_MOCK_DETAIL_COUNTER_H
+#define DRMOCK_SRC_DRMOCK_MOCK_DETAIL_COUNTER_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+namespace drmock { namespace detail {
+
+/* Counter
+
+Atomic counter which forwards every change to its parent, so that the
+value of a counter is the sum of its own changes and those of its
+children. Used to keep track of unsatisfied behaviors and failed
+methods, so that verification takes constant time.
+
+When a counter is destroyed or reparented, its value is moved from the
+old parent to the new one. `add` and `get` are thread-safe, `parent` is
+not.
+*/
+
+class Counter
+{
+public:
+  Counter() = default;
+  Counter(std::shared_ptr<Counter> parent);
+  ~Counter();
+
+  Counter(const Counter&) = delete;
+  Counter& operator=(const Counter&) = delete;
+
+  void add(std::ptrdiff_t n);
+  std::ptrdiff_t get() const;
+  void parent(std::shared_ptr<Counter> parent);
+
+private:
+  std::atomic<std::ptrdiff_t> value_{0};
+  std::shared_ptr<Counter> parent_{};
+};
+
+}} // namespace drmock::detail
+
+#endif /* DRMOCK_SRC_DRMOCK_MOCK_DETAIL_COUNTER_H */
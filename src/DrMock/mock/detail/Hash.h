@@ -0,0 +1,59 @@
+/* Copyright 2021 Ole Kliemann, Malte Kliemann
+ *
+ * This file is part of DrMock.
+ *
+ * DrMock is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DrMock is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DrMock.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef DRMOCK_SRC_DRMOCK_MOCK_DETAIL_HASH_H
+#define DRMOCK_SRC_DRMOCK_MOCK_DETAIL_HASH_H
+
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+
+#include <DrMock/utility/detail/TypeTraits.h>
+
+namespace drmock { namespace detail {
+
+/* is_hashable_by_equality
+
+`true` if `IsEqual<T>` compares objects of type `T` using `operator==`
+(case (1) of `IsEqual`) and `std::hash<T>` is enabled, so that objects
+which are equal in the sense of `Equal<T>` have equal hashes. Pointers
+are compared by their pointees and are therefore excluded.
+*/
+
+template<typename T>
+inline constexpr bool is_hashable_by_equality_v =
+        not drutility::detail::is_shared_ptr<T>::value
+    and not drutility::detail::is_unique_ptr<T>::value
+    and not drutility::detail::is_tuple<T>::value
+    and not std::is_pointer_v<T>
+    and not std::is_abstract_v<T>
+    and drutility::detail::is_hashable_v<T>;
+
+// Combine the hashes of `ts...` into one.
+template<typename... Ts>
+std::size_t
+hashAll(const Ts&... ts)
+{
+  std::size_t seed = 0;
+  ((seed ^= std::hash<Ts>{}(ts) + 0x9e3779b9 + (seed << 6) + (seed >> 2)), ...);
+  return seed;
+}
+
+}} // namespace drmock::detail
+
+#endif /* DRMOCK_SRC_DRMOCK_MOCK_DETAIL_HASH_H */
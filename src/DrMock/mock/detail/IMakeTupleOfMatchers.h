@@ -29,6 +29,8 @@
 
 namespace drmock { namespace detail {
 
+class Arena;
+
 template<typename... Bases>
 class IMakeTupleOfMatchers
 {
@@ -36,6 +38,9 @@ public:
   virtual ~IMakeTupleOfMatchers() = default;
   virtual std::tuple<std::shared_ptr<IMatcher<Bases>>...>
   wrap(Expect<Bases>&&... pack) = 0;
+  // Return a handler of the same type which allocates from `arena`.
+  virtual std::shared_ptr<IMakeTupleOfMatchers>
+  rebind(std::shared_ptr<Arena> arena) const = 0;
 };
 
 }} // namespace drmock::detail
@@ -24,6 +24,7 @@
 #endif /* _MSC_VER */
 
 #include <memory>
+#include <stdexcept>
 #include <type_traits>
 
 #include <DrMock/mock/detail/IIsEqual.h>
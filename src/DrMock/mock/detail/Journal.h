@@ -0,0 +1,95 @@
+/* Copyright 2021 Ole Kliemann, Malte Kliemann
+ *
+ * This file is part of DrMock.
+ *
+ * DrMock is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DrMock is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DrMock.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef DRMOCK_SRC_DRMOCK_MOCK_DETAIL_JOURNAL_H
+#define DRMOCK_SRC_DRMOCK_MOCK_DETAIL_JOURNAL_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include <DrMock/utility/detail/TypeTraits.h>
+
+namespace drmock { namespace detail {
+
+// Return the next global sequence number. Thread-safe.
+std::uint64_t nextSequenceNumber();
+
+/* Journal
+
+Ring buffer of the last `capacity` calls of a method. All entries are
+allocated up front. If all arguments are self-contained (see
+`drutility::detail::is_self_contained`), they are copied into the
+entries by assignment, so that recording only allocates if an argument
+needs more memory than the argument it overwrites (think
+`std::string`).
+
+Other arguments (pointers, views, smart pointers, user-defined types,
+and containers of these) may dangle or keep objects alive by the time
+the entries are inspected, so the arguments are converted to strings
+when they're recorded instead. Arguments which are not
+copy-constructible are not recorded.
+
+`record` may be called concurrently.
+*/
+
+template<typename... Args>
+class Journal
+{
+public:
+  static constexpr bool copyable = (std::is_copy_constructible_v<std::decay_t<Args>> and ...)
+      and (drutility::detail::is_self_contained_v<std::decay_t<Args>> and ...);
+  // True if the arguments are converted to strings when recorded.
+  static constexpr bool rendered = (std::is_copy_constructible_v<std::decay_t<Args>> and ...)
+      and not copyable;
+  // The type of the recorded arguments; a dummy if `not copyable`.
+  using Tuple = std::conditional_t<copyable, std::tuple<std::decay_t<Args>...>, std::tuple<>>;
+
+  struct Entry
+  {
+    std::uint64_t sequence = 0;
+    std::chrono::steady_clock::time_point time{};
+    std::optional<Tuple> args{};  // Empty if not recorded or `rendered`
+    std::vector<std::string> strings{};  // The arguments if `rendered`
+  };
+
+  Journal(std::size_t capacity);
+
+  void record(const Args&... args);
+  // Return the recorded entries, oldest first.
+  std::vector<Entry> entries() const;
+  // Return the number of calls recorded since construction, including
+  // those which were overwritten.
+  std::size_t num_recorded() const;
+
+private:
+  mutable std::mutex mtx_{};
+  std::vector<Entry> entries_{};  // Not resized after construction
+  std::size_t num_recorded_ = 0;
+};
+
+}} // namespace drmock::detail
+
+#include "Journal.tpp"
+
+#endif /* DRMOCK_SRC_DRMOCK_MOCK_DETAIL_JOURNAL_H */
@@ -0,0 +1,90 @@
+/* Copyright 2021 Ole Kliemann, Malte Kliemann
+ *
+ * This file is part of DrMock.
+ *
+ * DrMock is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DrMock is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DrMock.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+
+#include <DrMock/utility/detail/Diagnostics.h>
+
+namespace drmock { namespace detail {
+
+template<typename... Args>
+Journal<Args...>::Journal(std::size_t capacity)
+:
+  entries_(capacity)
+{}
+
+template<typename... Args>
+void
+Journal<Args...>::record(const Args&... args)
+{
+  if (entries_.empty())
+  {
+    return;
+  }
+  std::vector<std::string> strings{};
+  if constexpr (rendered)
+  {
+    drutility::detail::PrintAll<Args...>{}(strings, args...);
+  }
+
+  std::lock_guard<std::mutex> lck{mtx_};
+  auto& entry = entries_[num_recorded_ % entries_.size()];
+  ++num_recorded_;
+  entry.sequence = nextSequenceNumber();
+  entry.time = std::chrono::steady_clock::now();
+  if constexpr (copyable)
+  {
+    if (entry.args)
+    {
+      *entry.args = std::tie(args...);
+    }
+    else
+    {
+      entry.args.emplace(args...);
+    }
+  }
+  else if constexpr (rendered)
+  {
+    entry.strings = std::move(strings);
+  }
+}
+
+template<typename... Args>
+std::vector<typename Journal<Args...>::Entry>
+Journal<Args...>::entries() const
+{
+  std::lock_guard<std::mutex> lck{mtx_};
+  std::vector<Entry> result{};
+  auto size = std::min(num_recorded_, entries_.size());
+  result.reserve(size);
+  for (std::size_t i = num_recorded_ - size; i < num_recorded_; ++i)
+  {
+    result.push_back(entries_[i % entries_.size()]);
+  }
+  return result;
+}
+
+template<typename... Args>
+std::size_t
+Journal<Args...>::num_recorded() const
+{
+  std::lock_guard<std::mutex> lck{mtx_};
+  return num_recorded_;
+}
+
+}} // namespace drmock::detail
@@ -23,6 +23,7 @@
 #include <tuple>
 #include <type_traits>
 
+#include <DrMock/mock/detail/Arena.h>
 #include <DrMock/mock/detail/IMakeTupleOfMatchers.h>
 #include <DrMock/mock/Equal.h>
 #include <DrMock/mock/IMatcher.h>
@@ -39,6 +40,13 @@ struct MakeTupleOfMatchers<std::tuple<Bases...>, std::tuple<Deriveds...>>
 {
   static_assert(sizeof...(Bases) == sizeof...(Deriveds));
 
+  MakeTupleOfMatchers() = default;
+  // Allocate the matchers from `arena`.
+  MakeTupleOfMatchers(std::shared_ptr<Arena> arena)
+  :
+    arena_{std::move(arena)}
+  {}
+
   // Transform a tuple of `Variant<Args, IMatcher<Args>>...` into a
   // tuple of `std::shared_ptr<IMatcher<Args>>` by wrapping all "naked"
   // `Args` into `IsEqual<Bases, Deriveds>`.
@@ -48,6 +56,12 @@ struct MakeTupleOfMatchers<std::tuple<Bases...>, std::tuple<Deriveds...>>
     return std::make_tuple(wrap_impl<Bases, Deriveds>(std::forward<Expect<Bases>>(pack))...);
   }
 
+  std::shared_ptr<IMakeTupleOfMatchers<Bases...>>
+  rebind(std::shared_ptr<Arena> arena) const
+  {
+    return std::make_shared<MakeTupleOfMatchers>(std::move(arena));
+  }
+
 private:
   template<typename Base, typename Derived = Base>
   std::shared_ptr<IMatcher<Base>>
@@ -55,13 +69,18 @@ private:
   {
     if (var.template holdsAlternative<Base>())
     {
-      return std::make_shared<Equal<Base, Derived>>(std::forward<Expect<Base>>(var).template get<Base>());
+      return allocateShared<Equal<Base, Derived>>(
+          arena_,
+          std::forward<Expect<Base>>(var).template get<Base>()
+        );
     }
     else
     {
       return std::forward<Expect<Base>>(var).template get<std::shared_ptr<IMatcher<Base>>>();
     }
   }
+
+  std::shared_ptr<Arena> arena_{};
 };
 
 }} // namespace drmock::detail
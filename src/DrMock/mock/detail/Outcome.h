@@ -0,0 +1,36 @@
+/* Copyright 2021 Ole Kliemann, Malte Kliemann
+ *
+ * This file is part of DrMock.
+ *
+ * DrMock is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DrMock is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DrMock.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef DRMOCK_SRC_DRMOCK_MOCK_DETAIL_OUTCOME_H
+#define DRMOCK_SRC_DRMOCK_MOCK_DETAIL_OUTCOME_H
+
+#include <cstdint>
+
+namespace drmock { namespace detail {
+
+// Tag written after the arguments of a recorded call: The call returned
+// (followed by the serialized return value, unless the return type is
+// `void`) or threw (followed by `what()`).
+enum class Outcome : std::uint8_t
+{
+  value = 0,
+  exception = 1
+};
+
+}} // namespace drmock::detail
+
+#endif /* DRMOCK_SRC_DRMOCK_MOCK_DETAIL_OUTCOME_H */
@@ -0,0 +1,50 @@
+/* Copyright 2021 Ole Kliemann, Malte Kliemann
+ *
+ * This file is part of DrMock.
+ *
+ * DrMock is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DrMock is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DrMock.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef DRMOCK_SRC_DRMOCK_MOCK_DETAIL_PRODUCTION_H
+#define DRMOCK_SRC_DRMOCK_MOCK_DETAIL_PRODUCTION_H
+
+#include <exception>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+#include <DrMock/mock/AbstractSignal.h>
+
+namespace drmock { namespace detail {
+
+// Non-owning view of a result configured in a behavior: A pointer to
+// the return value (or `nullptr` if no value is returned) and a pointer
+// to the signal (or `nullptr` if no signal is emitted). Both are owned
+// by the behavior and remain valid as long as the behavior does, so
+// passing them around doesn't touch any reference counts.
+template<typename Class, typename ReturnType>
+using ResultRef = std::pair<std::decay_t<ReturnType>*, AbstractSignal<Class>*>;
+
+// The result of calling a behavior: No result (the call failed), a
+// result or an exception pointer.
+template<typename Class, typename ReturnType>
+using Production = std::variant<
+    std::monostate,
+    ResultRef<Class, ReturnType>,
+    std::exception_ptr
+  >;
+
+}} // namespace drmock::detail
+
+#endif /* DRMOCK_SRC_DRMOCK_MOCK_DETAIL_PRODUCTION_H */
@@ -0,0 +1,74 @@
+/* Copyright 2021 Ole Kliemann, Malte Kliemann
+ *
+ * This file is part of DrMock.
+ *
+ * DrMock is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DrMock is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DrMock.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef DRMOCK_SRC_DRMOCK_MOCK_DETAIL_SEGMENTEDVECTOR_H
+#define DRMOCK_SRC_DRMOCK_MOCK_DETAIL_SEGMENTEDVECTOR_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+namespace drmock { namespace detail {
+
+/* SegmentedVector
+
+Append-only array whose elements never move. The elements are stored in
+segments of doubling size, the first of which holds `base` elements.
+
+Calls of `grow` must be synchronized by the caller, but may run
+concurrently with access to elements which were appended before (in the
+sense of happens-before). Element access takes a few instructions and
+no locks.
+*/
+
+template<typename T>
+class SegmentedVector
+{
+public:
+  SegmentedVector() = default;
+  ~SegmentedVector();
+
+  SegmentedVector(const SegmentedVector&) = delete;
+  SegmentedVector& operator=(const SegmentedVector&) = delete;
+
+  // Append a value-initialized element and return its index.
+  std::size_t grow();
+  std::size_t size() const;
+
+  T& operator[](std::size_t index);
+  const T& operator[](std::size_t index) const;
+
+private:
+  static constexpr std::size_t log_base = 4;
+  static constexpr std::size_t base = std::size_t{1} << log_base;
+  static constexpr std::size_t num_segments = 8 * sizeof(std::size_t) - log_base;
+
+  // Return the segment of `index` and the offset of `index` in the
+  // segment.
+  static std::size_t segment(std::size_t index);
+  static std::size_t offset(std::size_t index, std::size_t segment);
+
+  std::array<std::atomic<T*>, num_segments> segments_{};
+  std::atomic<std::size_t> size_{0};
+};
+
+}} // namespace drmock::detail
+
+#include "SegmentedVector.tpp"
+
+#endif /* DRMOCK_SRC_DRMOCK_MOCK_DETAIL_SEGMENTEDVECTOR_H */
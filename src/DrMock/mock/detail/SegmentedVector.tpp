@@ -0,0 +1,92 @@
+/* Copyright 2021 Ole Kliemann, Malte Kliemann
+ *
+ * This file is part of DrMock.
+ *
+ * DrMock is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DrMock is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DrMock.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+namespace drmock { namespace detail {
+
+template<typename T>
+SegmentedVector<T>::~SegmentedVector()
+{
+  for (auto& p : segments_)
+  {
+    delete[] p.load(std::memory_order_relaxed);
+  }
+}
+
+template<typename T>
+std::size_t
+SegmentedVector<T>::grow()
+{
+  auto index = size_.load(std::memory_order_relaxed);
+  auto s = segment(index);
+  if (not segments_[s].load(std::memory_order_relaxed))
+  {
+    segments_[s].store(new T[base << s](), std::memory_order_release);
+  }
+  size_.store(index + 1, std::memory_order_release);
+  return index;
+}
+
+template<typename T>
+std::size_t
+SegmentedVector<T>::size() const
+{
+  return size_.load(std::memory_order_acquire);
+}
+
+template<typename T>
+T&
+SegmentedVector<T>::operator[](std::size_t index)
+{
+  auto s = segment(index);
+  return segments_[s].load(std::memory_order_acquire)[offset(index, s)];
+}
+
+template<typename T>
+const T&
+SegmentedVector<T>::operator[](std::size_t index) const
+{
+  auto s = segment(index);
+  return segments_[s].load(std::memory_order_acquire)[offset(index, s)];
+}
+
+template<typename T>
+std::size_t
+SegmentedVector<T>::segment(std::size_t index)
+{
+  // Segment `s` holds the indices `i` with `2^s <= (i + base) / base < 2^(s + 1)`.
+  std::size_t i = (index + base) >> log_base;
+#if defined(__GNUC__) || defined(__clang__)
+  return 8 * sizeof(unsigned long long) - 1 - __builtin_clzll(i);
+#else
+  std::size_t s = 0;
+  while (i >>= 1)
+  {
+    ++s;
+  }
+  return s;
+#endif
+}
+
+template<typename T>
+std::size_t
+SegmentedVector<T>::offset(std::size_t index, std::size_t segment)
+{
+  return index + base - (base << segment);
+}
+
+}} // namespace drmock::detail
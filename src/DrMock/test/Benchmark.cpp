@@ -0,0 +1,143 @@
+/* Copyright 2021 Ole Kliemann, Malte Kliemann
+ *
+ * This file is part of DrMock.
+ *
+ * DrMock is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DrMock is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DrMock.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+#include <DrMock/test/Report.h>
+
+namespace drtest { namespace detail {
+
+namespace {
+
+// Return the `p`-th percentile of the sorted `samples`.
+double
+percentile(const std::vector<double>& samples, double p)
+{
+  double pos = p*static_cast<double>(samples.size() - 1);
+  auto lower = static_cast<std::size_t>(std::floor(pos));
+  auto upper = std::min(lower + 1, samples.size() - 1);
+  double fraction = pos - static_cast<double>(lower);
+  return samples[lower] + fraction*(samples[upper] - samples[lower]);
+}
+
+std::string
+formatTime(double ns)
+{
+  const char* unit = "ns";
+  if (ns >= 1e9)
+  {
+    ns /= 1e9;
+    unit = "s";
+  }
+  else if (ns >= 1e6)
+  {
+    ns /= 1e6;
+    unit = "ms";
+  }
+  else if (ns >= 1e3)
+  {
+    ns /= 1e3;
+    unit = "us";
+  }
+  std::stringstream s{};
+  s << std::setprecision(3) << ns << " " << unit;
+  return s.str();
+}
+
+} // anonymous namespace
+
+Benchmark::Benchmark(std::size_t samples, Duration sample_time, Duration warmup_time)
+:
+  samples_{std::max(samples, std::size_t{1})},
+  sample_time_{sample_time},
+  warmup_time_{warmup_time}
+{}
+
+BenchmarkStatistics
+computeStatistics(std::vector<double> samples)
+{
+  BenchmarkStatistics result{};
+  result.samples = samples.size();
+  if (samples.empty())
+  {
+    return result;
+  }
+
+  std::sort(samples.begin(), samples.end());
+  result.median = percentile(samples, 0.5);
+  result.min = samples.front();
+  result.max = samples.back();
+  result.p90 = percentile(samples, 0.9);
+  result.p99 = percentile(samples, 0.99);
+
+  std::vector<double> deviations{};
+  deviations.reserve(samples.size());
+  for (double x : samples)
+  {
+    deviations.push_back(std::abs(x - result.median));
+  }
+  std::sort(deviations.begin(), deviations.end());
+  result.mad = percentile(deviations, 0.5);
+  return result;
+}
+
+std::string
+formatBenchmark(const BenchmarkResult& result)
+{
+  const auto& stats = result.statistics;
+  std::stringstream s{};
+  s << "median " << formatTime(stats.median)
+    << ", MAD " << formatTime(stats.mad)
+    << ", min " << formatTime(stats.min)
+    << ", p90 " << formatTime(stats.p90)
+    << ", p99 " << formatTime(stats.p99)
+    << " (" << stats.samples << " samples x " << result.iterations << " iterations)";
+  return s.str();
+}
+
+void
+writeBenchmarkJson(std::ostream& os, const std::vector<BenchmarkResult>& results)
+{
+  os << "[";
+  for (std::size_t i = 0; i < results.size(); ++i)
+  {
+    const auto& result = results[i];
+    const auto& stats = result.statistics;
+    os << (i == 0 ? "\n" : ",\n")
+       << "  {"
+       << "\"test\": \"" << escapeJson(result.test) << "\", "
+       << "\"row\": \"" << escapeJson(result.row) << "\", "
+       << "\"iterations\": " << result.iterations << ", "
+       << "\"samples\": " << stats.samples << ", "
+       << "\"median_ns\": " << stats.median << ", "
+       << "\"mad_ns\": " << stats.mad << ", "
+       << "\"min_ns\": " << stats.min << ", "
+       << "\"max_ns\": " << stats.max << ", "
+       << "\"p90_ns\": " << stats.p90 << ", "
+       << "\"p99_ns\": " << stats.p99
+       << "}";
+  }
+  os << "\n]\n";
+}
+
+}} // namespaces
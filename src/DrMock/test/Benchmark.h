@@ -0,0 +1,89 @@
+/* Copyright 2021 Ole Kliemann, Malte Kliemann
+ *
+ * This file is part of DrMock.
+ *
+ * DrMock is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DrMock is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DrMock.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef DRMOCK_SRC_DRMOCK_TEST_BENCHMARK_H
+#define DRMOCK_SRC_DRMOCK_TEST_BENCHMARK_H
+
+#include <chrono>
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace drtest { namespace detail {
+
+// Summary of the samples of a benchmark; all times are in nanoseconds
+// per iteration.
+struct BenchmarkStatistics
+{
+  std::size_t samples = 0;
+  double median = 0;
+  double mad = 0;  // Median absolute deviation from the median
+  double min = 0;
+  double max = 0;
+  double p90 = 0;
+  double p99 = 0;
+};
+
+struct BenchmarkResult
+{
+  std::string test;
+  std::string row;
+  std::size_t iterations;  // Iterations per sample
+  BenchmarkStatistics statistics;
+};
+
+/**
+ * Runner for microbenchmarks.
+ *
+ * `run` first calibrates the number of iterations per sample so that a
+ * sample takes at least `sample_time`, then runs the function for
+ * `warmup_time` without measuring and finally takes `samples` samples.
+ */
+class Benchmark
+{
+public:
+  using Duration = std::chrono::nanoseconds;
+
+  Benchmark() = default;
+  Benchmark(std::size_t samples, Duration sample_time, Duration warmup_time);
+
+  template<typename F> BenchmarkResult run(F&& f) const;
+
+private:
+  // Return the duration of `iterations` calls of `f`.
+  template<typename F> static Duration time(F& f, std::size_t iterations);
+
+  std::size_t samples_ = 21;
+  Duration sample_time_ = std::chrono::milliseconds{1};
+  Duration warmup_time_ = std::chrono::milliseconds{5};
+};
+
+// Return the statistics of `samples` (nanoseconds per iteration).
+// Percentiles are interpolated linearly.
+BenchmarkStatistics computeStatistics(std::vector<double> samples);
+// Return a human readable description of `result`.
+std::string formatBenchmark(const BenchmarkResult& result);
+// Write `results` as JSON array to `os`.
+void writeBenchmarkJson(std::ostream& os, const std::vector<BenchmarkResult>& results);
+
+}} // namespaces
+
+#include "Benchmark.tpp"
+
+#endif /* DRMOCK_SRC_DRMOCK_TEST_BENCHMARK_H */
@@ -0,0 +1,85 @@
+/* Copyright 2021 Ole Kliemann, Malte Kliemann
+ *
+ * This file is part of DrMock.
+ *
+ * DrMock is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DrMock is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DrMock.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include <vector>
+
+namespace drtest { namespace detail {
+
+template<typename F>
+BenchmarkResult
+Benchmark::run(F&& f) const
+{
+  // If the compiler optimizes `f` away, no number of iterations will
+  // do; stop at some point.
+  constexpr std::size_t max_iterations = std::size_t{1} << 30;
+
+  std::size_t iterations = 1;
+  while (iterations < max_iterations)
+  {
+    Duration elapsed = time(f, iterations);
+    if (elapsed >= sample_time_)
+    {
+      break;
+    }
+    // Aim a bit higher than `sample_time_` to avoid another round.
+    std::size_t factor = 2;
+    if (elapsed.count() > 0)
+    {
+      factor = static_cast<std::size_t>(
+          1.2*static_cast<double>(sample_time_.count())/static_cast<double>(elapsed.count())
+        );
+    }
+    iterations = std::min(
+        iterations*std::clamp(factor, std::size_t{2}, std::size_t{100}),
+        max_iterations
+      );
+  }
+
+  // Summing up the rounds would never reach `warmup_time_` if they
+  // measure zero; use a deadline instead.
+  auto deadline = std::chrono::steady_clock::now() + warmup_time_;
+  do
+  {
+    time(f, iterations);
+  } while (std::chrono::steady_clock::now() < deadline);
+
+  std::vector<double> samples{};
+  samples.reserve(samples_);
+  for (std::size_t i = 0; i < samples_; ++i)
+  {
+    samples.push_back(
+        static_cast<double>(time(f, iterations).count())/static_cast<double>(iterations)
+      );
+  }
+  return {{}, {}, iterations, computeStatistics(std::move(samples))};
+}
+
+template<typename F>
+Benchmark::Duration
+Benchmark::time(F& f, std::size_t iterations)
+{
+  auto start = std::chrono::steady_clock::now();
+  for (std::size_t i = 0; i < iterations; ++i)
+  {
+    f();
+  }
+  return std::chrono::duration_cast<Duration>(std::chrono::steady_clock::now() - start);
+}
+
+}} // namespaces
@@ -0,0 +1,63 @@
+/* Copyright 2021 Ole Kliemann, Malte Kliemann
+ *
+ * This file is part of DrMock.
+ *
+ * DrMock is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DrMock is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DrMock.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef DRMOCK_SRC_DRMOCK_TEST_COLUMNHANDLE_H
+#define DRMOCK_SRC_DRMOCK_TEST_COLUMNHANDLE_H
+
+#include <string>
+
+#include <DrMock/test/TestObject.h>
+
+namespace drtest { namespace detail {
+
+/**
+ * Reference to a column of the test table of a test.
+ *
+ * The column is looked up when the handle is constructed; accessing
+ * the value of the current row is then a bounds check followed by an
+ * array access. The handle remains valid as long as the test table
+ * is not modified.
+ */
+template<typename T>
+class ColumnHandle
+{
+public:
+  ColumnHandle(const TestObject& test, std::string column);
+
+  /**
+   * Return the value of the column in the row running on the calling
+   * thread.
+   *
+   * @throws std::logic_error If no row is running or the row has no
+   * value in the column
+   */
+  const T& get() const;
+  const T& operator*() const;
+  const T* operator->() const;
+
+private:
+  const TestObject* test_;
+  std::string column_;
+  const TestObject::Column<T>* values_;
+};
+
+}} // namespaces
+
+#include "ColumnHandle.tpp"
+
+#endif /* DRMOCK_SRC_DRMOCK_TEST_COLUMNHANDLE_H */
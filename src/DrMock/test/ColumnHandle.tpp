@@ -0,0 +1,64 @@
+/* Copyright 2021 Ole Kliemann, Malte Kliemann
+ *
+ * This file is part of DrMock.
+ *
+ * DrMock is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DrMock is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DrMock.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <stdexcept>
+
+namespace drtest { namespace detail {
+
+template<typename T>
+ColumnHandle<T>::ColumnHandle(const TestObject& test, std::string column)
+:
+  test_{&test},
+  column_{std::move(column)},
+  values_{&test.column<T>(column_)}
+{}
+
+template<typename T>
+const T&
+ColumnHandle<T>::get() const
+{
+  std::size_t row = TestObject::currentRow();
+  if (row < values_->size() and (*values_)[row])
+  {
+    return *(*values_)[row];
+  }
+
+  if (row == TestObject::no_row)
+  {
+    throw std::logic_error{"no data provided for column: " + column_};
+  }
+  throw std::logic_error{
+      "no value in row: \"" + test_->rowName(row) + "\", column: " + column_
+    };
+}
+
+template<typename T>
+const T&
+ColumnHandle<T>::operator*() const
+{
+  return get();
+}
+
+template<typename T>
+const T*
+ColumnHandle<T>::operator->() const
+{
+  return &get();
+}
+
+}} // namespaces
@@ -31,8 +31,10 @@
 
 namespace drtest { namespace death {
 
-[[maybe_unused]] static int pipe_[2];
-volatile std::sig_atomic_t atomic_pipe_;  // Self-pipe write end; required due to https://en.cppreference.com/w/c/program/signal
+// The pipe is thread-local so that death tests may run on concurrent
+// workers (see `--jobs`).
+[[maybe_unused]] static thread_local int pipe_[2];
+static thread_local volatile std::sig_atomic_t atomic_pipe_;  // Self-pipe write end; required due to https://en.cppreference.com/w/c/program/signal
 
 static std::vector<int> signals_ = {  // POSIX signals, taken from https://man7.org/linux/man-pages/man7/signal.7.html
     SIGABRT,
@@ -18,10 +18,19 @@
 
 #include "Global.h"
 
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <mutex>
 #include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <tuple>
 
+#include <DrMock/utility/BufferingLogger.h>
 #include <DrMock/utility/ILogger.h>
 #include <DrMock/utility/Singleton.tpp>
+#include <DrMock/utility/detail/ScopeGuard.h>
 
 template class drutility::Singleton<drtest::detail::Global>;
 
@@ -47,7 +56,8 @@ Global::addTest(std::string test_name)
 {
   if (tests_.find(test_name) == tests_.end())
   {
-    tests_.insert({test_name, TestObject{test_name}});
+    auto it = tests_.insert({test_name, TestObject{test_name}}).first;
+    std::get<TestObject>(*it).setSpareThreads(&spare_threads_);
     test_names_.push_back(std::move(test_name));
   }
 }
@@ -66,52 +76,244 @@ Global::addDataFunc(const std::string& test_name, std::function<void()> data_fun
   tests_[test_name].setDataFunc(std::move(data_func));
 }
 
+void
+Global::addBenchmarkFunc(const std::string& test_name, std::function<void()> benchmark_func)
+{
+  addTestFunc(test_name, std::move(benchmark_func));
+  benchmark_names_.insert(test_name);
+}
+
+void
+Global::addBenchmarkResult(BenchmarkResult result)
+{
+  TestObject& test = current_test();
+  result.test = test.name();
+  result.row = test.rowName(TestObject::currentRow());
+
+  std::string location = result.test;
+  if (not result.row.empty())
+  {
+    location += ", " + result.row;
+  }
+  drutility::Singleton<drutility::ILogger>::get()->logMessage(
+      false,
+      "BENCH",
+      location,
+      -1,
+      std::stringstream{} << formatBenchmark(result)
+    );
+
+  std::lock_guard lck{benchmark_mtx_};
+  benchmark_results_.push_back(std::move(result));
+}
+
 void
 Global::runTests()
 {
-  TestObject& initTestCase = tests_["initTestCase"];
-  TestObject& cleanupTestCase = tests_["cleanupTestCase"];
+  TestObject* previous_test = TestObject::current();
+  TestObject& initTestCase = tests_.at("initTestCase");
+  TestObject& cleanupTestCase = tests_.at("cleanupTestCase");
+  fixtures_.clear();
+  results_.clear();
+  spare_threads_ = numThreads() - 1;
 
+  TestObject::setCurrent(&initTestCase);
   initTestCase.runTest(false);
-  if (initTestCase.num_failures() != 0)
+  addResults(initTestCase);
+  if (initTestCase.num_failures() == 0)
   {
-    return;
+    bool done = (options_.jobs == 1) ? runTestsSerial() : runTestsParallel();
+    if (done)
+    {
+      TestObject::setCurrent(&cleanupTestCase);
+      cleanupTestCase.runTest(false);
+      addResults(cleanupTestCase);
+    }
   }
+  TestObject::setCurrent(previous_test);
+}
 
-  for (auto& test_name : test_names_)
+bool
+Global::runTestsSerial()
+{
+  TestObject& init = tests_.at("init");
+  TestObject& cleanup = tests_.at("cleanup");
+  for (const auto& test_name : test_names_)
   {
     if (reserved_names_.find(test_name) != reserved_names_.end())
     {
       continue;
     }
+    if (not runTest(test_name, init, cleanup))
+    {
+      return false;
+    }
+  }
+  return true;
+}
 
-    current_test_ = test_name;
+bool
+Global::runTestsParallel()
+{
+  std::size_t num_workers = numThreads();
 
-    TestObject& init = tests_["init"];
-    TestObject& test = tests_[test_name];
-    TestObject& cleanup = tests_["cleanup"];
+  // Divert the log of every test into a buffer and forward the buffers
+  // in order of registration, so that the output does not depend on
+  // scheduling.
+  auto logger = drutility::Singleton<drutility::ILogger>::get();
+  auto buffering_logger = std::make_shared<drutility::BufferingLogger>(logger);
+  drutility::Singleton<drutility::ILogger>::set(buffering_logger);
 
-    init.runTest(false);
-    if (init.num_failures() != 0)
+  std::size_t num_tests = test_names_.size();
+  std::vector<drutility::BufferingLogger::Buffer> buffers(num_tests);
+  std::vector<bool> finished(num_tests, false);
+  std::size_t next_flush = 0;
+  std::mutex mtx{};
+  auto finish = [&] (std::size_t i) {
+    std::lock_guard lck{mtx};
+    finished[i] = true;
+    for (; next_flush < num_tests and finished[next_flush]; ++next_flush)
     {
-      return;
+      buffering_logger->replay(buffers[next_flush]);
+      buffers[next_flush] = {};
     }
+  };
+
+  std::atomic<std::size_t> next_test{0};
+  std::atomic<bool> aborted{false};
+  auto work = [&] (TestObject* init, TestObject* cleanup) {
+    for (std::size_t i = next_test++; i < num_tests and not aborted; i = next_test++)
+    {
+      const std::string& test_name = test_names_[i];
+      if (reserved_names_.find(test_name) == reserved_names_.end()
+          and not isBenchmark(test_name))
+      {
+        drutility::BufferingLogger::capture(&buffers[i]);
+        if (not runTest(test_name, *init, *cleanup))
+        {
+          aborted = true;
+        }
+        drutility::BufferingLogger::capture(nullptr);
+      }
+      finish(i);
+    }
+    // Idle workers leave their thread to the parallel rows of the tests
+    // still running.
+    ++spare_threads_;
+  };
+
+  // Every worker runs its own copy of `init` and `cleanup`.
+  spare_threads_ = 0;
+  fixtures_.reserve(2*num_workers);
+  std::vector<std::thread> workers{};
+  // If a thread fails to start, the workers already running must be
+  // stopped and joined before the error is propagated.
+  drutility::detail::ScopeGuard guard{[&] () {
+    aborted = true;
+    for (auto& worker : workers)
+    {
+      worker.join();
+    }
+    drutility::Singleton<drutility::ILogger>::set(logger);
+  }};
+  for (std::size_t k = 0; k < num_workers; ++k)
+  {
+    fixtures_.push_back(tests_.at("init"));
+    fixtures_.push_back(tests_.at("cleanup"));
+    workers.emplace_back(work, &fixtures_[2*k], &fixtures_[2*k + 1]);
+  }
+  guard.dismiss();
+  for (auto& worker : workers)
+  {
+    worker.join();
+  }
+  spare_threads_ = num_workers - 1;
 
-    test.prepareTestData();
-    if (test.num_failures() != 0)
+  // If the run was aborted, there may be gaps in the sequence of
+  // finished tests.
+  for (std::size_t i = next_flush; i < num_tests; ++i)
+  {
+    if (finished[i])
     {
-      return;
+      buffering_logger->replay(buffers[i]);
     }
-    test.runTest(true);
+  }
+  drutility::Singleton<drutility::ILogger>::set(logger);
+  if (aborted)
+  {
+    return false;
+  }
 
-    cleanup.runTest(false);
-    if (init.num_failures() != 0)
+  // Benchmarks must not time each other's contention, so they are run
+  // one after another once the pool is drained.
+  TestObject& init = tests_.at("init");
+  TestObject& cleanup = tests_.at("cleanup");
+  for (const auto& test_name : test_names_)
+  {
+    if (isBenchmark(test_name) and not runTest(test_name, init, cleanup))
     {
-      return;
+      return false;
     }
   }
+  return true;
+}
+
+bool
+Global::runTest(const std::string& test_name, TestObject& init, TestObject& cleanup)
+{
+  TestObject& test = tests_.at(test_name);
+  // Data driven tests are sharded by row, see `TestObject::runTest`.
+  if (not test.hasData() and not shard_.contains(test_name))
+  {
+    return true;
+  }
+  bool is_benchmark = isBenchmark(test_name);
+  if ((options_.benchmarks == BenchmarkMode::skip and is_benchmark)
+      or (options_.benchmarks == BenchmarkMode::only and not is_benchmark))
+  {
+    return true;
+  }
+  TestObject::setCurrent(&test);
 
-  cleanupTestCase.runTest(false);
+  init.runTest(false);
+  addResults(init, test_name);
+  if (init.num_failures() != 0)
+  {
+    return false;
+  }
+
+  test.prepareTestData();
+  if (test.num_failures() != 0)
+  {
+    addResults(test);
+    return false;
+  }
+  test.runTest(true, shard_);
+  addResults(test);
+
+  cleanup.runTest(false);
+  addResults(cleanup, test_name);
+  if (cleanup.num_failures() != 0)
+  {
+    return false;
+  }
+  return true;
+}
+
+bool
+Global::isBenchmark(const std::string& test_name) const
+{
+  return benchmark_names_.find(test_name) != benchmark_names_.end();
+}
+
+std::size_t
+Global::numThreads() const
+{
+  if (options_.jobs == 0)
+  {
+    return std::max(std::thread::hardware_concurrency(), 1u);
+  }
+  return options_.jobs;
 }
 
 std::size_t
@@ -122,6 +324,10 @@ Global::num_failures() const
   {
     result += std::get<TestObject>(test).num_failures();
   }
+  for (auto& fixture : fixtures_)
+  {
+    result += fixture.num_failures();
+  }
   return result;
 }
 
@@ -129,7 +335,118 @@ void
 Global::runTestsAndLog()
 {
   runTests();
+  std::size_t failed = num_failures();
+  writeReports();
+  if (not options_.summary_file.empty())
+  {
+    try
+    {
+      writeSummary(options_.summary_file, {shard_.index(), shard_.count(), failed});
+    }
+    catch(const std::runtime_error& e)
+    {
+      drutility::Singleton<drutility::ILogger>::get()->logMessage(
+          false,
+          "*ERROR",
+          "",
+          -1,
+          std::stringstream{} << e.what()
+        );
+    }
+  }
+  logResult(failed);
+}
 
+void
+Global::writeReports()
+{
+  auto log_error = [] (const std::string& msg) {
+    drutility::Singleton<drutility::ILogger>::get()->logMessage(
+        false,
+        "*ERROR",
+        "",
+        -1,
+        std::stringstream{} << msg
+      );
+  };
+
+  if (not options_.benchmark_json.empty())
+  {
+    // Sort the results so that the output doesn't depend on the order
+    // in which the rows ran.
+    std::sort(
+        benchmark_results_.begin(),
+        benchmark_results_.end(),
+        [] (const BenchmarkResult& lhs, const BenchmarkResult& rhs) {
+          return std::tie(lhs.test, lhs.row) < std::tie(rhs.test, rhs.row);
+        }
+      );
+    std::ofstream f{options_.benchmark_json};
+    writeBenchmarkJson(f, benchmark_results_);
+    if (not f)
+    {
+      log_error("failed to write benchmark results: " + options_.benchmark_json);
+    }
+  }
+
+  if (not options_.report.empty())
+  {
+    try
+    {
+      writeReport(options_.report, options_.name.empty() ? "drtest" : options_.name, results_);
+    }
+    catch(const std::runtime_error& e)
+    {
+      log_error(e.what());
+    }
+  }
+}
+
+void
+Global::addResults(const TestObject& test, const std::string& context)
+{
+  std::lock_guard lck{results_mtx_};
+  for (auto result : test.results())
+  {
+    result.context = context;
+    results_.push_back(std::move(result));
+  }
+}
+
+std::size_t
+Global::mergeSummariesAndLog()
+{
+  auto logger = drutility::Singleton<drutility::ILogger>::get();
+  std::size_t failed = 0;
+  try
+  {
+    std::vector<ShardSummary> summaries{};
+    for (const auto& path : options_.merge_summaries)
+    {
+      summaries.push_back(readSummary(path));
+      const auto& summary = summaries.back();
+      logger->logMessage(
+          false,
+          "SHARD",
+          std::to_string(summary.index) + "/" + std::to_string(summary.count),
+          -1,
+          std::stringstream{} << summary.failures << " FAILED"
+        );
+    }
+    failed = mergeSummaries(summaries);
+  }
+  catch(const std::runtime_error& e)
+  {
+    logger->logMessage(false, "*ERROR", "", -1, std::stringstream{} << e.what());
+    failed = 1;
+  }
+  logResult(failed);
+  return failed;
+}
+
+void
+Global::logResult(std::size_t failed)
+{
   drutility::Singleton<drutility::ILogger>::get()->logMessage(
       false,
       "",
@@ -137,7 +454,6 @@ Global::runTestsAndLog()
       -1,
       std::stringstream{} << "****************"
    );
-  std::size_t failed = num_failures();
   if (failed == 0)
   {
     drutility::Singleton<drutility::ILogger>::get()->logMessage(
@@ -163,25 +479,43 @@ Global::runTestsAndLog()
 void
 Global::abs_tol(double value)
 {
-  tests_[current_test_].abs_tol(value);
+  current_test().abs_tol(value);
 }
 
 void
 Global::rel_tol(double value)
 {
-  tests_[current_test_].rel_tol(value);
+  current_test().rel_tol(value);
 }
 
 void
 Global::xfail()
 {
-  tests_[current_test_].xfail();
+  current_test().xfail();
 }
 
 void
 Global::tagRow(const std::string& row, tags tag)
 {
-  tests_[current_test_].tagRow(row, tag);
+  current_test().tagRow(row, tag);
+}
+
+void
+Global::configure(const Options& options)
+{
+  options_ = options;
+  shard_ = Shard{options.shard_index, options.shard_count};
+}
+
+TestObject&
+Global::current_test()
+{
+  TestObject* test = TestObject::current();
+  if (not test)
+  {
+    throw std::logic_error{"no test running"};
+  }
+  return *test;
 }
 
 }} // namespaces
@@ -19,11 +19,17 @@
 #ifndef DRMOCK_SRC_DRMOCK_TEST_GLOBAL_H
 #define DRMOCK_SRC_DRMOCK_TEST_GLOBAL_H
 
+#include <atomic>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
+#include <DrMock/test/Benchmark.h>
+#include <DrMock/test/ColumnHandle.h>
+#include <DrMock/test/Options.h>
+#include <DrMock/test/Shard.h>
 #include <DrMock/test/Tags.h>
 #include <DrMock/test/TestObject.h>
 #include <DrMock/utility/Singleton.h>
@@ -37,20 +43,45 @@ public:
 
   void addTestFunc(const std::string&, std::function<void()>);
   void addDataFunc(const std::string&, std::function<void()>);
+  void addBenchmarkFunc(const std::string&, std::function<void()>);
+  // Log `result` as result of the current test and row and add it to
+  // the benchmark results.
+  void addBenchmarkResult(BenchmarkResult result);
   template<typename T> void addColumn(std::string);
   template<typename... Ts> void addRow(const std::string& row, Ts&&... ts);
   template<typename T> T fetchData(const std::string& column);
+  template<typename T> const std::decay_t<T>& fetchDataRef(const std::string& column);
+  template<typename T> ColumnHandle<T> column(std::string column);
   void runTestsAndLog();
+  // Merge the summaries of a sharded test run specified in the options,
+  // log the result and return the total number of failures.
+  std::size_t mergeSummariesAndLog();
   std::size_t num_failures() const;
   template<typename T> bool almostEqual(T actual, T expected);
   void abs_tol(double value);
   void rel_tol(double value);
   void xfail();
   void tagRow(const std::string& row, tags tag);
+  void configure(const Options&);
 
 private:
   void addTest(std::string);
   void runTests();
+  bool runTestsSerial();
+  bool runTestsParallel();
+  // Run `init`, `test_name` and `cleanup`; return `false` if the test
+  // run must be aborted.
+  bool runTest(const std::string& test_name, TestObject& init, TestObject& cleanup);
+  bool isBenchmark(const std::string& test_name) const;
+  // Return the number of threads of the test run, see `--jobs`.
+  std::size_t numThreads() const;
+  void logResult(std::size_t failed);
+  // Add the results of the last run of `test` to the report; `context`
+  // is the test for which the fixture `test` was run.
+  void addResults(const TestObject& test, const std::string& context = {});
+  void writeReports();
+  // Return the test that is running on the calling thread.
+  TestObject& current_test();
 
   std::unordered_set<std::string> reserved_names_;
   std::vector<std::string> test_names_;
@@ -58,8 +89,17 @@ private:
       std::string, // test name
       TestObject
     > tests_;
-
-  std::string current_test_;
+  std::vector<TestObject> fixtures_{};  // Per-worker copies of `init` and `cleanup`
+  // Threads of the test run which are not running a test, available for
+  // parallel rows, see `TestObject::setSpareThreads`.
+  std::atomic<std::size_t> spare_threads_{0};
+  std::unordered_set<std::string> benchmark_names_{};
+  std::mutex benchmark_mtx_{};
+  std::vector<BenchmarkResult> benchmark_results_{};
+  std::mutex results_mtx_{};
+  std::vector<TestResult> results_{};
+  Options options_{};
+  Shard shard_{};
 };
 
 }} // namespaces
@@ -22,28 +22,42 @@ template<typename T>
 void
 Global::addColumn(std::string column)
 {
-  tests_[current_test_].addColumn<T>(std::move(column));
+  current_test().addColumn<T>(std::move(column));
 }
 
 template<typename... Ts>
 void
 Global::addRow(const std::string& row, Ts&&... ts)
 {
-  tests_[current_test_].addRow(row, std::forward<Ts>(ts)...);
+  current_test().addRow(row, std::forward<Ts>(ts)...);
 }
 
 template<typename T>
 T
 Global::fetchData(const std::string& column)
 {
-  return tests_[current_test_].fetchData<T>(column);
+  return current_test().fetchData<T>(column);
+}
+
+template<typename T>
+const std::decay_t<T>&
+Global::fetchDataRef(const std::string& column)
+{
+  return current_test().fetchDataRef<T>(column);
+}
+
+template<typename T>
+ColumnHandle<T>
+Global::column(std::string column)
+{
+  return ColumnHandle<T>{current_test(), std::move(column)};
 }
 
 template<typename T>
 bool
 Global::almostEqual(T actual, T expected)
 {
-  return tests_[current_test_].almostEqual(actual, expected);
+  return current_test().almostEqual(actual, expected);
 }
 
 }} // namespaces
@@ -21,6 +21,7 @@
 
 #include <string>
 
+#include <DrMock/test/ColumnHandle.h>
 #include <DrMock/test/Tags.h>
 
 namespace drtest {
@@ -35,6 +36,7 @@ using Replace = T2;
 template<typename T> void addColumn(std::string);
 template<typename... Ts> void addColumns(detail::Replace<Ts, std::string>...);
 template<typename... Ts> void addRow(const std::string& row, Ts&&... ts);
+template<typename T> detail::ColumnHandle<T> column(std::string column);
 template<typename T> bool almostEqual(T actual, T expected);
 void abs_tol(double value);
 void rel_tol(double value);
@@ -42,6 +44,11 @@ void tagRow(const std::string& row, tags tag);
 void skip();
 void skip(std::string what);
 void xfail();
+// Run `f` repeatedly and log and record statistics of its run time as
+// result of the current test (and row).
+template<typename F> void measure(F&& f);
+// Prevent the compiler from optimizing away the computation of `value`.
+template<typename T> void doNotOptimize(const T& value);
 
 } // namespace drtest
 
@@ -41,6 +41,33 @@ addRow(const std::string& row, Ts&&... ts)
   drutility::Singleton<detail::Global>::get()->addRow(row, std::forward<Ts>(ts)...);
 }
 
+template<typename T>
+detail::ColumnHandle<T>
+column(std::string column)
+{
+  return drutility::Singleton<detail::Global>::get()->column<T>(std::move(column));
+}
+
+template<typename F>
+void
+measure(F&& f)
+{
+  auto result = detail::Benchmark{}.run(std::forward<F>(f));
+  drutility::Singleton<detail::Global>::get()->addBenchmarkResult(std::move(result));
+}
+
+template<typename T>
+void
+doNotOptimize(const T& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+  asm volatile("" : : "r,m"(value) : "memory");
+#else
+  const volatile void* p = &value;
+  (void) p;
+#endif
+}
+
 template<typename T>
 bool
 almostEqual(T actual, T expected)
@@ -0,0 +1,185 @@
+/* Copyright 2021 Ole Kliemann, Malte Kliemann
+ *
+ * This file is part of DrMock.
+ *
+ * DrMock is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DrMock is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DrMock.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "Options.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+
+namespace drtest { namespace detail {
+
+namespace {
+
+std::invalid_argument
+invalidValue(const std::string& option, const std::string& value)
+{
+  return std::invalid_argument{"invalid value for " + option + ": \"" + value + "\""};
+}
+
+std::size_t
+toSize(const std::string& option, const std::string& value)
+{
+  std::size_t pos = 0;
+  unsigned long result = 0;
+  try
+  {
+    result = std::stoul(value, &pos);
+  }
+  catch(const std::exception&)
+  {
+    pos = 0;
+  }
+  if (value.empty() or pos != value.size() or value[0] == '-')
+  {
+    throw invalidValue(option, value);
+  }
+  return static_cast<std::size_t>(result);
+}
+
+const std::vector<std::string> known_options = {
+    "--jobs",
+    "--shard-index",
+    "--shard-count",
+    "--summary-file",
+    "--merge-summary",
+    "--async-log",
+    "--benchmarks",
+    "--benchmark-json",
+    "--report"
+  };
+
+} // anonymous namespace
+
+Options
+parseOptions(int argc, char** argv)
+{
+  Options result{};
+  if (argc > 0)
+  {
+    std::string program{argv[0]};
+    result.name = program.substr(program.find_last_of("/\\") + 1);
+  }
+  if (const char* env = std::getenv("DRTEST_SHARD_INDEX"))
+  {
+    result.shard_index = toSize("DRTEST_SHARD_INDEX", env);
+  }
+  if (const char* env = std::getenv("DRTEST_SHARD_COUNT"))
+  {
+    result.shard_count = toSize("DRTEST_SHARD_COUNT", env);
+  }
+
+  for (int i = 1; i < argc; ++i)
+  {
+    std::string arg{argv[i]};
+    std::string option = arg.substr(0, arg.find('='));
+    std::string value{};
+    if (std::find(known_options.begin(), known_options.end(), option) == known_options.end())
+    {
+      continue;
+    }
+
+    if (option.size() < arg.size())
+    {
+      value = arg.substr(option.size() + 1);
+    }
+    else if (i + 1 < argc)
+    {
+      value = argv[++i];
+    }
+    else
+    {
+      throw std::invalid_argument{"missing value for " + option};
+    }
+
+    if (option == "--jobs")
+    {
+      result.jobs = toSize(option, value);
+    }
+    else if (option == "--shard-index")
+    {
+      result.shard_index = toSize(option, value);
+    }
+    else if (option == "--shard-count")
+    {
+      result.shard_count = toSize(option, value);
+    }
+    else if (option == "--summary-file")
+    {
+      result.summary_file = value;
+    }
+    else if (option == "--merge-summary")
+    {
+      result.merge_summaries.push_back(value);
+    }
+    else if (option == "--async-log")
+    {
+      if (value == "block")
+      {
+        result.async_log = drutility::AsyncLogger::Policy::block;
+      }
+      else if (value == "drop")
+      {
+        result.async_log = drutility::AsyncLogger::Policy::drop;
+      }
+      else
+      {
+        throw invalidValue(option, value);
+      }
+    }
+    else if (option == "--benchmarks")
+    {
+      if (value == "run")
+      {
+        result.benchmarks = BenchmarkMode::run;
+      }
+      else if (value == "skip")
+      {
+        result.benchmarks = BenchmarkMode::skip;
+      }
+      else if (value == "only")
+      {
+        result.benchmarks = BenchmarkMode::only;
+      }
+      else
+      {
+        throw invalidValue(option, value);
+      }
+    }
+    else if (option == "--benchmark-json")
+    {
+      result.benchmark_json = value;
+    }
+    else if (option == "--report")
+    {
+      result.report = value;
+    }
+  }
+
+  if (result.shard_count == 0 or result.shard_index >= result.shard_count)
+  {
+    throw std::invalid_argument{
+        "invalid shard: index " + std::to_string(result.shard_index)
+        + " of " + std::to_string(result.shard_count)
+      };
+  }
+  return result;
+}
+
+}} // namespaces
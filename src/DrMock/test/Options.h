@@ -0,0 +1,62 @@
+/* Copyright 2021 Ole Kliemann, Malte Kliemann
+ *
+ * This file is part of DrMock.
+ *
+ * DrMock is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DrMock is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DrMock.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef DRMOCK_SRC_DRMOCK_TEST_OPTIONS_H
+#define DRMOCK_SRC_DRMOCK_TEST_OPTIONS_H
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <DrMock/utility/AsyncLogger.h>
+
+namespace drtest { namespace detail {
+
+// Which tests to run.
+enum class BenchmarkMode
+{
+  run,  // Run tests and benchmarks
+  skip,  // Run tests only
+  only  // Run benchmarks only
+};
+
+// Command line options of the test executable.
+struct Options
+{
+  std::string name{};  // Name of the test executable
+  std::size_t jobs = 1;  // Number of worker threads; 0 means one per core
+  std::size_t shard_index = 0;
+  std::size_t shard_count = 1;
+  std::string summary_file{};  // Write the shard summary to this file
+  std::vector<std::string> merge_summaries{};  // Merge these summaries instead of running tests
+  std::optional<drutility::AsyncLogger::Policy> async_log{};  // Log using `AsyncLogger` with this policy
+  BenchmarkMode benchmarks = BenchmarkMode::run;
+  std::string benchmark_json{};  // Write the benchmark results to this file
+  std::string report{};  // Write a report with the results of all tests to this file
+};
+
+// Parse the command line arguments `argv`. The environment variables
+// `DRTEST_SHARD_INDEX` and `DRTEST_SHARD_COUNT` serve as defaults for
+// the corresponding options. Throw `std::invalid_argument` if an
+// option is malformed. Unknown arguments are ignored.
+Options parseOptions(int argc, char** argv);
+
+}} // namespaces
+
+#endif /* DRMOCK_SRC_DRMOCK_TEST_OPTIONS_H */
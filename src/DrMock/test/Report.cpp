@@ -0,0 +1,236 @@
+/* Copyright 2021 Ole Kliemann, Malte Kliemann
+ *
+ * This file is part of DrMock.
+ *
+ * DrMock is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DrMock is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DrMock.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "Report.h"
+
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+namespace drtest { namespace detail {
+
+namespace {
+
+const char*
+toString(Status status)
+{
+  switch (status)
+  {
+    case Status::pass:
+      return "pass";
+    case Status::fail:
+      return "fail";
+    case Status::skip:
+      return "skip";
+    case Status::xfail:
+      return "xfail";
+  }
+  return "";
+}
+
+// Return the name of the JUnit test case of `result`.
+std::string
+caseName(const TestResult& result)
+{
+  std::string name = result.row.empty() ? result.test : result.row;
+  if (not result.context.empty())
+  {
+    name += " (" + result.context + ")";
+  }
+  return name;
+}
+
+} // anonymous namespace
+
+void
+writeReport(
+    const std::string& path,
+    const std::string& name,
+    const std::vector<TestResult>& results
+  )
+{
+  std::ofstream f{path};
+  std::string extension = ".xml";
+  if (path.size() >= extension.size()
+      and path.compare(path.size() - extension.size(), extension.size(), extension) == 0)
+  {
+    writeJUnitReport(f, name, results);
+  }
+  else
+  {
+    writeJsonReport(f, name, results);
+  }
+  if (not f)
+  {
+    throw std::runtime_error{"failed to write report: " + path};
+  }
+}
+
+void
+writeJsonReport(
+    std::ostream& os,
+    const std::string& name,
+    const std::vector<TestResult>& results
+  )
+{
+  os << "{\n"
+     << "  \"name\": \"" << escapeJson(name) << "\",\n"
+     << "  \"results\": [";
+  for (std::size_t i = 0; i < results.size(); ++i)
+  {
+    const auto& result = results[i];
+    os << (i == 0 ? "\n" : ",\n")
+       << "    {"
+       << "\"test\": \"" << escapeJson(result.test) << "\", "
+       << "\"row\": \"" << escapeJson(result.row) << "\", ";
+    if (not result.context.empty())
+    {
+      os << "\"context\": \"" << escapeJson(result.context) << "\", ";
+    }
+    os << "\"status\": \"" << toString(result.status) << "\", "
+       << "\"wall_time\": " << result.wall_time << ", "
+       << "\"cpu_time\": " << result.cpu_time;
+    if (not result.message.empty())
+    {
+      os << ", \"message\": \"" << escapeJson(result.message) << "\"";
+    }
+    os << "}";
+  }
+  os << "\n  ]\n}\n";
+}
+
+void
+writeJUnitReport(
+    std::ostream& os,
+    const std::string& name,
+    const std::vector<TestResult>& results
+  )
+{
+  std::size_t failures = 0;
+  std::size_t skipped = 0;
+  double time = 0;
+  for (const auto& result : results)
+  {
+    failures += (result.status == Status::fail);
+    skipped += (result.status == Status::skip);
+    time += result.wall_time;
+  }
+
+  os << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+     << "<testsuite"
+     << " name=\"" << escapeXml(name) << "\""
+     << " tests=\"" << results.size() << "\""
+     << " failures=\"" << failures << "\""
+     << " skipped=\"" << skipped << "\""
+     << " time=\"" << time << "\">\n";
+  for (const auto& result : results)
+  {
+    os << "  <testcase"
+       << " classname=\"" << escapeXml(result.test) << "\""
+       << " name=\"" << escapeXml(caseName(result)) << "\""
+       << " time=\"" << result.wall_time << "\"";
+    switch (result.status)
+    {
+      case Status::fail:
+        os << ">\n"
+           << "    <failure message=\"" << escapeXml(result.message) << "\"/>\n"
+           << "  </testcase>\n";
+        break;
+      case Status::skip:
+        os << ">\n"
+           << "    <skipped/>\n"
+           << "  </testcase>\n";
+        break;
+      default:
+        os << "/>\n";
+    }
+  }
+  os << "</testsuite>\n";
+}
+
+std::string
+escapeJson(const std::string& s)
+{
+  std::stringstream result{};
+  for (unsigned char c : s)
+  {
+    switch (c)
+    {
+      case '"':
+        result << "\\\"";
+        break;
+      case '\\':
+        result << "\\\\";
+        break;
+      case '\n':
+        result << "\\n";
+        break;
+      case '\t':
+        result << "\\t";
+        break;
+      default:
+        if (c < 0x20)
+        {
+          result << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+                 << static_cast<int>(c) << std::dec << std::setfill(' ');
+        }
+        else
+        {
+          result << c;
+        }
+    }
+  }
+  return result.str();
+}
+
+std::string
+escapeXml(const std::string& s)
+{
+  std::string result{};
+  for (unsigned char c : s)
+  {
+    switch (c)
+    {
+      case '"':
+        result += "&quot;";
+        break;
+      case '&':
+        result += "&amp;";
+        break;
+      case '<':
+        result += "&lt;";
+        break;
+      case '>':
+        result += "&gt;";
+        break;
+      case '\n':
+        result += "&#10;";
+        break;
+      default:
+        // Other control characters are not allowed in XML 1.0.
+        if (c >= 0x20 or c == '\t')
+        {
+          result += static_cast<char>(c);
+        }
+    }
+  }
+  return result;
+}
+
+}} // namespaces
@@ -0,0 +1,74 @@
+/* Copyright 2021 Ole Kliemann, Malte Kliemann
+ *
+ * This file is part of DrMock.
+ *
+ * DrMock is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DrMock is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DrMock.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef DRMOCK_SRC_DRMOCK_TEST_REPORT_H
+#define DRMOCK_SRC_DRMOCK_TEST_REPORT_H
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace drtest { namespace detail {
+
+enum class Status
+{
+  pass,
+  fail,
+  skip,
+  xfail
+};
+
+// Result of running a test with one row.
+struct TestResult
+{
+  std::string test{};
+  std::string row{};
+  std::string context{};  // For `init` and `cleanup`: the test they ran for
+  Status status = Status::pass;
+  std::string message{};
+  double wall_time = 0;  // Seconds
+  double cpu_time = 0;  // Seconds of CPU time of the running thread
+};
+
+// Write `results` to the file `path`; as JUnit XML if the extension of
+// `path` is `.xml`, as JSON otherwise. `name` is the name of the test
+// suite. Throw `std::runtime_error` if the file cannot be written.
+void writeReport(
+    const std::string& path,
+    const std::string& name,
+    const std::vector<TestResult>& results
+  );
+void writeJsonReport(
+    std::ostream& os,
+    const std::string& name,
+    const std::vector<TestResult>& results
+  );
+void writeJUnitReport(
+    std::ostream& os,
+    const std::string& name,
+    const std::vector<TestResult>& results
+  );
+
+// Escape `s` for use in a JSON string.
+std::string escapeJson(const std::string& s);
+// Escape `s` for use in XML text and attribute values.
+std::string escapeXml(const std::string& s);
+
+}} // namespaces
+
+#endif /* DRMOCK_SRC_DRMOCK_TEST_REPORT_H */
@@ -0,0 +1,143 @@
+/* Copyright 2021 Ole Kliemann, Malte Kliemann
+ *
+ * This file is part of DrMock.
+ *
+ * DrMock is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DrMock is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DrMock.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "Shard.h"
+
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+
+namespace drtest { namespace detail {
+
+namespace {
+
+const std::string summary_magic = "drtest-shard";
+
+std::uint64_t
+fnv1a(const std::string& s)
+{
+  std::uint64_t hash = 14695981039346656037ull;
+  for (unsigned char c : s)
+  {
+    hash ^= c;
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
+} // anonymous namespace
+
+Shard::Shard(std::size_t index, std::size_t count)
+:
+  index_{index},
+  count_{count}
+{
+  if (count_ == 0 or index_ >= count_)
+  {
+    throw std::invalid_argument{
+        "invalid shard: " + std::to_string(index_) + " of " + std::to_string(count_)
+      };
+  }
+}
+
+bool
+Shard::contains(const std::string& key) const
+{
+  return (count_ == 1) or (fnv1a(key) % count_ == index_);
+}
+
+std::size_t
+Shard::index() const
+{
+  return index_;
+}
+
+std::size_t
+Shard::count() const
+{
+  return count_;
+}
+
+void
+writeSummary(const std::string& path, const ShardSummary& summary)
+{
+  std::ofstream f{path};
+  f << summary_magic << " "
+    << summary.index << " "
+    << summary.count << " "
+    << summary.failures << std::endl;
+  if (not f)
+  {
+    throw std::runtime_error{"failed to write summary: " + path};
+  }
+}
+
+ShardSummary
+readSummary(const std::string& path)
+{
+  std::ifstream f{path};
+  if (not f)
+  {
+    throw std::runtime_error{"failed to read summary: " + path};
+  }
+  std::string magic{};
+  ShardSummary result{};
+  f >> magic >> result.index >> result.count >> result.failures;
+  if (not f or magic != summary_magic)
+  {
+    throw std::runtime_error{"malformed summary: " + path};
+  }
+  return result;
+}
+
+std::size_t
+mergeSummaries(const std::vector<ShardSummary>& summaries)
+{
+  if (summaries.empty())
+  {
+    throw std::runtime_error{"no summaries to merge"};
+  }
+  std::size_t count = summaries.front().count;
+  std::vector<bool> seen(count, false);
+  std::size_t result = 0;
+  for (const auto& summary : summaries)
+  {
+    if (summary.count != count or summary.index >= count)
+    {
+      throw std::runtime_error{"summaries with inconsistent shard count"};
+    }
+    if (seen[summary.index])
+    {
+      throw std::runtime_error{
+          "duplicate summary for shard " + std::to_string(summary.index)
+        };
+    }
+    seen[summary.index] = true;
+    result += summary.failures;
+  }
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    if (not seen[i])
+    {
+      throw std::runtime_error{"missing summary for shard " + std::to_string(i)};
+    }
+  }
+  return result;
+}
+
+}} // namespaces
@@ -0,0 +1,77 @@
+/* Copyright 2021 Ole Kliemann, Malte Kliemann
+ *
+ * This file is part of DrMock.
+ *
+ * DrMock is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DrMock is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DrMock.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef DRMOCK_SRC_DRMOCK_TEST_SHARD_H
+#define DRMOCK_SRC_DRMOCK_TEST_SHARD_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace drtest { namespace detail {
+
+/**
+ * A slice of the tests and data rows of a test executable.
+ *
+ * A test or row belongs to the shard if the FNV-1a hash of its name
+ * modulo `count` equals `index`. The hash does not depend on the
+ * platform or the order of definition, so adding a test does not move
+ * other tests to other shards.
+ */
+class Shard
+{
+public:
+  Shard() = default;
+  Shard(std::size_t index, std::size_t count);
+
+  /**
+   * Check if the test or row with name `key` belongs to `this`.
+   */
+  bool contains(const std::string& key) const;
+
+  std::size_t index() const;
+  std::size_t count() const;
+
+private:
+  std::size_t index_ = 0;
+  std::size_t count_ = 1;
+};
+
+// Result of running one shard; written by the shard and merged in
+// summary mode.
+struct ShardSummary
+{
+  std::size_t index;
+  std::size_t count;
+  std::size_t failures;
+};
+
+// Write `summary` to the file `path`. Throw `std::runtime_error` if
+// the file cannot be written.
+void writeSummary(const std::string& path, const ShardSummary& summary);
+// Read a summary written by `writeSummary`. Throw
+// `std::runtime_error` if the file cannot be read or is malformed.
+ShardSummary readSummary(const std::string& path);
+// Return the total number of failures of `summaries`. Throw
+// `std::runtime_error` unless the summaries cover every shard exactly
+// once.
+std::size_t mergeSummaries(const std::vector<ShardSummary>& summaries);
+
+}} // namespaces
+
+#endif /* DRMOCK_SRC_DRMOCK_TEST_SHARD_H */
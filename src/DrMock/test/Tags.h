@@ -25,7 +25,8 @@ enum class tags
 {
   none = 0,
   skip = (1 << 0),
-  xfail = (1 << 1)
+  xfail = (1 << 1),
+  parallel = (1 << 2)  // Row may run concurrently with other parallel rows
 };
 
 inline tags
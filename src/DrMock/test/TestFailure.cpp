@@ -29,7 +29,22 @@ TestFailure::TestFailure(int line, std::string expr)
 const char*
 TestFailure::what() const noexcept
 {
-  return what_.c_str();
+  if (not lazy_)
+  {
+    return what_.c_str();
+  }
+  std::call_once(lazy_->once, [this] () {
+      try
+      {
+        lazy_->what = lazy_->render();
+      }
+      catch(...)
+      {
+        lazy_->what = "failed to render message";
+      }
+      lazy_->render = nullptr;
+    });
+  return lazy_->what.c_str();
 }
 
 int
@@ -20,13 +20,31 @@
 #define DRMOCK_SRC_DRMOCK_TEST_TESTFAILURE_H
 
 #include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <sstream>
 #include <string>
+#include <type_traits>
 
 #include <DrMock/utility/detail/Diagnostics.h>
+#include <DrMock/utility/detail/TypeTraits.h>
 
 namespace drtest { namespace detail {
 
+/**
+ * Exception thrown by failed assertions.
+ *
+ * The message of a failed comparison is rendered only when `what()` is
+ * first called. Until then, the exception holds copies of the
+ * operands. This makes failures which are expected and caught, for
+ * example by `DRTEST_ASSERT_TEST_FAIL`, cheap. Only operands which are
+ * self-contained (see `drutility::detail::is_self_contained`) are
+ * copied; all others may refer to objects which are gone once the
+ * stack is unwound, and are rendered immediately. Rendering is
+ * synchronized, so `what()` may be called concurrently on copies of
+ * the same failure.
+ */
 class TestFailure : public std::exception
 {
 public:
@@ -44,8 +62,26 @@ public:
   int line() const noexcept;
 
 private:
+  template<typename LhsType, typename RhsType> static std::string render(
+      const std::string& op,
+      const std::string& lhs_expr,
+      const LhsType& lhs,
+      const RhsType& rhs
+    );
+
+  // Message which is rendered on first use; shared by the copies of
+  // the exception.
+  struct Lazy
+  {
+    std::once_flag once{};
+    std::function<std::string()> render{};
+    std::string what{};
+  };
+
   int line_ = 0;
   std::string what_{};
+  // `nullptr` if the message was rendered immediately.
+  std::shared_ptr<Lazy> lazy_{};
 };
 
 template<typename LhsType, typename RhsType>
@@ -53,20 +89,48 @@ TestFailure::TestFailure(
     int line,
     std::string op,
     std::string lhs_expr,
-    std::string rhs_expr,
+    [[maybe_unused]] std::string rhs_expr,  // Not printed.
     const LhsType& lhs,
     const RhsType& rhs
   )
 :
   TestFailure{line, {}}
+{
+  if constexpr(drutility::detail::is_self_contained_v<std::decay_t<LhsType>>
+                and drutility::detail::is_self_contained_v<std::decay_t<RhsType>>
+                and std::is_copy_constructible_v<LhsType>
+                and std::is_copy_constructible_v<RhsType>)
+  {
+    lazy_ = std::make_shared<Lazy>();
+    lazy_->render = [op = std::move(op),
+                     lhs_expr = std::move(lhs_expr),
+                     lhs,
+                     rhs] () {
+        return render(op, lhs_expr, lhs, rhs);
+      };
+  }
+  else
+  {
+    what_ = render(op, lhs_expr, lhs, rhs);
+  }
+}
+
+template<typename LhsType, typename RhsType>
+std::string
+TestFailure::render(
+    const std::string& op,
+    const std::string& lhs_expr,
+    const LhsType& lhs,
+    const RhsType& rhs
+  )
 {
   std::stringstream s{};
   s << std::endl;
-  s << "    (" << std::move(lhs_expr) << ") " << std::endl;
+  s << "    (" << lhs_expr << ") " << std::endl;
   s << "      " << drutility::detail::StreamIfStreamable<LhsType>{lhs} << std::endl;
   s << "    (expected " << op << ")" << std::endl;
   s << "      " << drutility::detail::StreamIfStreamable<RhsType>{rhs} << std::endl;
-  what_ = s.str();
+  return s.str();
 }
 
 }} // namespace drtest::detail
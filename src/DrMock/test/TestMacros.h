@@ -29,7 +29,12 @@
 #endif
 
 #define DRTEST_FETCH(Type, name) \
-Type name{drutility::Singleton<drtest::detail::Global>::get()->fetchData<Type>(#name)}
+static thread_local drtest::detail::TestObject::ColumnCache name##DRTEST_column{}; \
+[[maybe_unused]] Type name{drtest::detail::TestObject::fetchCurrentRef<Type>(#name, name##DRTEST_column)}
+
+#define DRTEST_FETCH_REF(Type, name) \
+static thread_local drtest::detail::TestObject::ColumnCache name##DRTEST_column{}; \
+[[maybe_unused]] const Type& name{drtest::detail::TestObject::fetchCurrentRef<Type>(#name, name##DRTEST_column)}
 
 #define DRTEST_DATA(name) \
 void name##DRTEST_Data(); \
@@ -47,6 +52,15 @@ FunctionInvoker name##_test_pusher{[] () { drutility::Singleton<Global>::get()->
 }} \
 void DRTEST_NAMESPACE:: name()
 
+#define DRTEST_BENCHMARK(name) \
+namespace DRTEST_NAMESPACE { \
+void name(); \
+} \
+namespace drtest { namespace detail { \
+FunctionInvoker name##_benchmark_pusher{[] () { drutility::Singleton<Global>::get()->addBenchmarkFunc(#name, &DRTEST_NAMESPACE:: name); }}; \
+}} \
+void DRTEST_NAMESPACE:: name()
+
 #define DRTEST_ASSERT(p) \
 do { if (not (p)) throw drtest::detail::TestFailure{__LINE__, #p}; } while (false)
 
@@ -114,8 +128,10 @@ do { \
 
 #ifdef USING_DRTEST
 #define FETCH DRTEST_FETCH
+#define FETCH_REF DRTEST_FETCH_REF
 #define DATA DRTEST_DATA
 #define TEST DRTEST_TEST
+#define BENCHMARK DRTEST_BENCHMARK
 #define ASSERT DRTEST_ASSERT
 #define ASSERT_EQ DRTEST_ASSERT_EQ
 #define ASSERT_NE DRTEST_ASSERT_NE
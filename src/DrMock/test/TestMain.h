@@ -24,8 +24,14 @@
 #include <QTimer>
 #endif
 
+#include <cstdlib>
+#include <sstream>
+#include <stdexcept>
+
 #include <DrMock/test/FunctionInvoker.h>
 #include <DrMock/test/Global.h>
+#include <DrMock/test/Options.h>
+#include <DrMock/utility/AsyncLogger.h>
 #include <DrMock/utility/ILogger.h>
 #include <DrMock/utility/Logger.h>
 
@@ -47,18 +53,57 @@ main(int argc, char** argv)
 
 #ifdef DRTEST_USE_QT
   QCoreApplication qapp{argc, argv};
-  QTimer::singleShot(0, [&] ()
-      {
-        GlobalSingleton::get()->runTestsAndLog();
-        qapp.exit();
-      }
-    );
-  qapp.exec();
+#endif
+
+  drtest::detail::Options options{};
+  try
+  {
+    options = drtest::detail::parseOptions(argc, argv);
+  }
+  catch(const std::invalid_argument& e)
+  {
+    LoggerSingleton::get()->logMessage(false, "*ERROR", "", -1, std::stringstream{} << e.what());
+    return EXIT_FAILURE;
+  }
+  GlobalSingleton::get()->configure(options);
+
+  std::shared_ptr<drutility::AsyncLogger> async_logger{};
+  if (options.async_log)
+  {
+    async_logger = std::make_shared<drutility::AsyncLogger>(*options.async_log);
+    LoggerSingleton::set(async_logger);
+  }
+
+  int result = 0;
+  if (not options.merge_summaries.empty())
+  {
+    result = static_cast<int>(GlobalSingleton::get()->mergeSummariesAndLog());
+  }
+  else
+  {
+#ifdef DRTEST_USE_QT
+    QTimer::singleShot(0, [&] ()
+        {
+          GlobalSingleton::get()->runTestsAndLog();
+          qapp.exit();
+        }
+      );
+    qapp.exec();
 #else
-  GlobalSingleton::get()->runTestsAndLog();
+    GlobalSingleton::get()->runTestsAndLog();
 #endif
+    result = static_cast<int>(GlobalSingleton::get()->num_failures());
+  }
 
-  return static_cast<int>(GlobalSingleton::get()->num_failures());
+  // Drain the log before exiting. Messages logged after this point
+  // (for example, from destructors of static objects) are written
+  // synchronously.
+  if (async_logger)
+  {
+    LoggerSingleton::set(std::make_shared<Logger>());
+    async_logger->flush();
+  }
+  return result;
 }
 
 #endif /* DRMOCK_SRC_DRMOCK_TEST_TESTMAIN_H */
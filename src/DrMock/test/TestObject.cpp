@@ -18,11 +18,19 @@
 
 #include "TestObject.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <ctime>
 #include <sstream>
+#include <stdexcept>
+#include <thread>
 
 #include <DrMock/test/SkipTest.h>
 #include <DrMock/test/TestFailure.h>
+#include <DrMock/utility/BufferingLogger.h>
 #include <DrMock/utility/ILogger.h>
+#include <DrMock/utility/detail/ScopeGuard.h>
 
 namespace drtest { namespace detail {
 
@@ -51,8 +59,25 @@ void log(
    );
 }
 
+// Return the CPU time used by the calling thread in seconds.
+double
+threadCpuTime()
+{
+#if defined(__unix__) || defined(__APPLE__)
+  timespec t{};
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &t);
+  return static_cast<double>(t.tv_sec) + 1e-9*static_cast<double>(t.tv_nsec);
+#else
+  return static_cast<double>(std::clock())/CLOCKS_PER_SEC;
+#endif
+}
+
 } // anonymous namespace
 
+thread_local TestObject* TestObject::current_ = nullptr;
+thread_local std::size_t TestObject::current_row_ = TestObject::no_row;
+thread_local TestObject::State* TestObject::row_state_ = nullptr;
+
 TestObject::TestObject(std::string name)
 :
   name_{std::move(name)}
@@ -70,50 +95,75 @@ TestObject::setDataFunc(std::function<void()> data_func)
   data_func_ = std::move(data_func);
 }
 
+TestResult
+TestObject::runOneTest(std::size_t row, bool verbose_logging)
+{
+  std::size_t previous_row = current_row_;
+  current_row_ = row;
+  TestResult result{};
+  result.test = name_;
+  result.row = rowName(row);
+  auto wall_start = std::chrono::steady_clock::now();
+  double cpu_start = threadCpuTime();
+  runOneTestImpl(row, verbose_logging, result);
+  result.cpu_time = threadCpuTime() - cpu_start;
+  result.wall_time = std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - wall_start
+    ).count();
+  current_row_ = previous_row;
+  return result;
+}
+
 void
-TestObject::runOneTest(const std::string& row, bool verbose_logging)
+TestObject::runOneTestImpl(std::size_t index, bool verbose_logging, TestResult& result)
 {
+  const std::string& row = result.row;
   if (verbose_logging)
   {
     log("TEST", name_, row, -1, {});
   }
-  if ((tags_[row] & tags::skip) == tags::skip)
+  if (hasTag(index, tags::skip))
   {
     log("SKIP", name_, row, -1, {});
+    result.status = Status::skip;
     return;
   }
   try
   {
     test_func_();
   }
-  catch(const SkipTest&)
+  catch(const SkipTest& e)
   {
     log("SKIP", name_, row, -1, {});
+    result.status = Status::skip;
+    result.message = e.what();
     return;
   }
   catch(const TestFailure& e)
   {
-    if (xfail_ or ((tags_[row] & tags::xfail) == tags::xfail))
+    result.message = e.what();
+    if (state().xfail or hasTag(index, tags::xfail))
     {
-      log("XFAIL", name_, row, e.line(), e.what());
-    }
-    else
-    {
-      log("*FAIL", name_, row, e.line(), e.what());
-      failed_rows_.push_back(row);
+      log("XFAIL", name_, row, e.line(), result.message);
+      result.status = Status::xfail;
+      return;
     }
+    log("*FAIL", name_, row, e.line(), result.message);
+    result.status = Status::fail;
     return;
   }
   catch(const std::logic_error& e)
   {
-    log("*FAIL", name_, row, -1, std::string{"logic_error: "} + std::string{e.what()});
-    failed_rows_.push_back(row);
+    result.message = std::string{"logic_error: "} + std::string{e.what()};
+    log("*FAIL", name_, row, -1, result.message);
+    result.status = Status::fail;
     return;
   }
   catch(const std::exception& e)
   {
-    log("*FAIL", name_, row, -1, e.what());
-    failed_rows_.push_back(row);
+    result.message = e.what();
+    log("*FAIL", name_, row, -1, result.message);
+    result.status = Status::fail;
     return;
   }
   if (verbose_logging)
@@ -135,28 +185,197 @@ TestObject::prepareTestData()
     {
       log("*ERROR", name_, "data", -1, e.what());
       failed_rows_.push_back("data");
+      results_.push_back({name_, "data", {}, Status::fail, e.what()});
     }
   }
 }
 
 void
-TestObject::runTest(bool verbose_logging)
+TestObject::runTest(bool verbose_logging, const Shard& shard)
 {
   failed_rows_.clear();
-  if (data_rows_.size() > 0)
+  results_.clear();
+  if (data_rows_.empty())
+  {
+    addResult(runOneTest(no_row, verbose_logging));
+    return;
+  }
+
+  std::vector<std::size_t> rows{};
+  bool parallel = false;
+  for (std::size_t i = 0; i < data_rows_.size(); ++i)
   {
-    for (const auto& row : data_rows_)
+    if (shard.contains(name_ + "/" + data_rows_[i]))
     {
-      current_row_ = row;
-      runOneTest(row, verbose_logging);
+      rows.push_back(i);
+      parallel = parallel or hasTag(i, tags::parallel);
     }
   }
-  else
+
+  if (parallel)
   {
-    runOneTest({}, verbose_logging);
+    runRowsParallel(rows, verbose_logging);
+    return;
+  }
+  for (auto row : rows)
+  {
+    addResult(runOneTest(row, verbose_logging));
   }
 }
 
+void
+TestObject::runRowsParallel(const std::vector<std::size_t>& rows, bool verbose_logging)
+{
+  // Divert the log of every row into a buffer and forward the buffers
+  // in order of the rows, see `Global::runTestsParallel`. If a
+  // `BufferingLogger` is already installed, the buffers are forwarded
+  // into the buffer of the calling thread.
+  auto logger = drutility::Singleton<drutility::ILogger>::get();
+  auto buffering_logger = std::dynamic_pointer_cast<drutility::BufferingLogger>(logger);
+  if (not buffering_logger)
+  {
+    buffering_logger = std::make_shared<drutility::BufferingLogger>(logger);
+    drutility::Singleton<drutility::ILogger>::set(buffering_logger);
+  }
+
+  std::size_t num_rows = rows.size();
+  std::vector<drutility::BufferingLogger::Buffer> buffers(num_rows);
+  std::vector<TestResult> results(num_rows);
+  auto run = [&] (std::size_t i) {
+    auto previous = drutility::BufferingLogger::capture(&buffers[i]);
+    results[i] = runOneTest(rows[i], verbose_logging);
+    drutility::BufferingLogger::capture(previous);
+  };
+
+  std::vector<std::size_t> parallel_rows{};
+  for (std::size_t i = 0; i < num_rows; ++i)
+  {
+    if (hasTag(rows[i], tags::parallel))
+    {
+      parallel_rows.push_back(i);
+    }
+    else
+    {
+      run(i);
+    }
+  }
+
+  TestObject* test = current_;
+  std::atomic<std::size_t> next{0};
+  auto work = [&] () {
+    current_ = test;
+    for (std::size_t k = next++; k < parallel_rows.size(); k = next++)
+    {
+      // Parallel rows must not race on (or leak into each other's)
+      // tolerances, so every row gets its own copy.
+      State state = state_;
+      row_state_ = &state;
+      run(parallel_rows[k]);
+      row_state_ = nullptr;
+    }
+  };
+
+  // The calling thread is joined by as many threads as the test run has
+  // to spare, see `Global::runTests`.
+  std::size_t num_helpers = 0;
+  if (spare_threads_ and not parallel_rows.empty())
+  {
+    std::size_t spare = spare_threads_->load();
+    do
+    {
+      num_helpers = std::min(spare, parallel_rows.size() - 1);
+    } while (not spare_threads_->compare_exchange_weak(spare, spare - num_helpers));
+  }
+  std::vector<std::thread> helpers{};
+  // If a helper fails to start, the helpers already running finish the
+  // rows, the borrowed threads are returned and the logger is restored
+  // before the error is propagated.
+  drutility::detail::ScopeGuard guard{[&] () {
+    for (auto& helper : helpers)
+    {
+      helper.join();
+    }
+    if (spare_threads_)
+    {
+      *spare_threads_ += num_helpers;
+    }
+    drutility::Singleton<drutility::ILogger>::set(logger);
+  }};
+  for (std::size_t k = 0; k < num_helpers; ++k)
+  {
+    helpers.emplace_back(work);
+  }
+  guard.dismiss();
+  work();
+  for (auto& helper : helpers)
+  {
+    helper.join();
+  }
+  if (spare_threads_)
+  {
+    *spare_threads_ += num_helpers;
+  }
+
+  for (std::size_t i = 0; i < num_rows; ++i)
+  {
+    buffering_logger->replay(buffers[i]);
+    addResult(std::move(results[i]));
+  }
+  drutility::Singleton<drutility::ILogger>::set(logger);
+}
+
+void
+TestObject::addResult(TestResult result)
+{
+  if (result.status == Status::fail)
+  {
+    failed_rows_.push_back(result.row);
+  }
+  results_.push_back(std::move(result));
+}
+
+bool
+TestObject::hasTag(std::size_t row, tags tag) const
+{
+  return (row < tags_.size()) and ((tags_[row] & tag) == tag);
+}
+
+std::size_t
+TestObject::columnIndex(const std::string& column) const
+{
+  auto it = data_column_indices_.find(column);
+  if (it == data_column_indices_.end())
+  {
+    throw std::logic_error{"no such column: " + column};
+  }
+  return std::get<std::size_t>(*it);
+}
+
+const std::string&
+TestObject::name() const
+{
+  return name_;
+}
+
+const std::string&
+TestObject::rowName(std::size_t row) const
+{
+  static const std::string no_name{};
+  return (row < data_rows_.size()) ? data_rows_[row] : no_name;
+}
+
+bool
+TestObject::hasData() const
+{
+  return static_cast<bool>(data_func_);
+}
+
+const std::vector<TestResult>&
+TestObject::results() const
+{
+  return results_;
+}
+
 std::size_t
 TestObject::num_failures() const
 {
@@ -166,25 +385,66 @@ TestObject::num_failures() const
 void
 TestObject::abs_tol(double value)
 {
-  abs_tol_ = value;
+  state().abs_tol = value;
 }
 
 void
 TestObject::rel_tol(double value)
 {
-  rel_tol_ = value;
+  state().rel_tol = value;
 }
 
 void
 TestObject::xfail()
 {
-  xfail_ = true;
+  state().xfail = true;
+}
+
+TestObject::State&
+TestObject::state()
+{
+  return row_state_ ? *row_state_ : state_;
+}
+
+const TestObject::State&
+TestObject::state() const
+{
+  return row_state_ ? *row_state_ : state_;
 }
 
 void
 TestObject::tagRow(const std::string& row, tags tag)
 {
-  tags_[row] |= tag;
+  auto it = data_row_indices_.find(row);
+  if (it == data_row_indices_.end())
+  {
+    throw std::logic_error{"tagging row: \"" + row + "\": no such row"};
+  }
+  tags_[std::get<std::size_t>(*it)] |= tag;
+}
+
+void
+TestObject::setSpareThreads(std::atomic<std::size_t>* spare_threads)
+{
+  spare_threads_ = spare_threads;
+}
+
+TestObject*
+TestObject::current()
+{
+  return current_;
+}
+
+void
+TestObject::setCurrent(TestObject* test)
+{
+  current_ = test;
+}
+
+std::size_t
+TestObject::currentRow()
+{
+  return current_row_;
 }
 
 }} // namespaces
@@ -20,14 +20,21 @@
 #define DRMOCK_SRC_DRMOCK_TEST_TESTOBJECT_H
 
 #include <any>
+#include <atomic>
 #include <functional>
+#include <limits>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <typeindex>
 #include <tuple>
+#include <type_traits>
 #include <unordered_map>
 #include <vector>
 
 #include <DrMock/utility/Compare.h>
+#include <DrMock/test/Report.h>
+#include <DrMock/test/Shard.h>
 #include <DrMock/test/Tags.h>
 
 namespace drtest { namespace detail {
@@ -35,6 +42,20 @@ namespace drtest { namespace detail {
 class TestObject
 {
 public:
+  // Values of a data column; `std::nullopt` if the row has no value in
+  // the column.
+  template<typename T> using Column = std::vector<std::optional<T>>;
+
+  static constexpr std::size_t no_row = std::numeric_limits<std::size_t>::max();
+
+  // Index of a column, cached at the call site of `DRTEST_FETCH` so
+  // that the column name is only looked up once per test.
+  struct ColumnCache
+  {
+    const TestObject* test = nullptr;
+    std::size_t index = 0;
+  };
+
   TestObject() = default;
   explicit TestObject(std::string);
 
@@ -43,48 +64,108 @@ public:
   template<typename T> void addColumn(std::string);
   template<typename... Ts> void addRow(const std::string& row, Ts&&... ts);
   template<typename T> T fetchData(const std::string& column) const;
+  // Like `fetchData`, but return a reference into the table.
+  template<typename T> const std::decay_t<T>& fetchDataRef(const std::string& column) const;
+  // Like `fetchData` and `fetchDataRef`, but look up `column` only if
+  // `cache` doesn't belong to this test.
+  template<typename T> T fetchData(std::string_view column, ColumnCache& cache) const;
+  template<typename T> const std::decay_t<T>& fetchDataRef(std::string_view column, ColumnCache& cache) const;
+  // Like `fetchDataRef`, but with the test that is running on the
+  // calling thread. Used by `DRTEST_FETCH`, so that fetching doesn't go
+  // through the (locked) `Global` singleton. Throw `std::logic_error`
+  // if no test is running.
+  template<typename T> static const std::decay_t<T>& fetchCurrentRef(std::string_view column, ColumnCache& cache);
+  // Return the values of `column`. Throw `std::logic_error` if there is
+  // no such column or its type is not `T`.
+  template<typename T> const Column<T>& column(const std::string& column) const;
   void prepareTestData();
-  void runTest(bool verbose_logging = true);
+  // Run the test with every data row contained in `shard`.
+  void runTest(bool verbose_logging = true, const Shard& shard = {});
+  bool hasData() const;
   std::size_t num_failures() const;
+  // Return the results of the last run.
+  const std::vector<TestResult>& results() const;
   template<typename T> bool almostEqual(T actual, T expected) const;
   void abs_tol(double value);
   void rel_tol(double value);
   void xfail();
   void tagRow(const std::string& row, tags tag);
+  // Set the number of threads that may be started to run parallel rows
+  // in addition to the calling thread, shared with other tests. Without
+  // it, parallel rows are run on the calling thread.
+  void setSpareThreads(std::atomic<std::size_t>*);
+
+  const std::string& name() const;
+  const std::string& rowName(std::size_t row) const;
+
+  // Return the test that is running on the calling thread, or `nullptr`.
+  static TestObject* current();
+  static void setCurrent(TestObject*);
+  // Return the index of the row that is running on the calling thread,
+  // or `no_row`.
+  static std::size_t currentRow();
 
 private:
-  void runOneTest(const std::string& row, bool verbose_logging);
+  // Run the test with the row with index `row` (or without data if
+  // `row` is `no_row`) and return the result.
+  TestResult runOneTest(std::size_t row, bool verbose_logging);
+  void runOneTestImpl(std::size_t row, bool verbose_logging, TestResult& result);
+  void addResult(TestResult result);
+  // Run `rows`; the rows tagged `parallel` are run concurrently, the
+  // others on the calling thread. Shall only be called from `runTest`.
+  void runRowsParallel(const std::vector<std::size_t>& rows, bool verbose_logging);
+  bool hasTag(std::size_t row, tags tag) const;
+  // Return the index of `column`. Throw `std::logic_error` if there is
+  // no such column.
+  std::size_t columnIndex(const std::string& column) const;
+  // Like `column`, but with the column at index `col`, whose name
+  // `column` is only used for error messages.
+  template<typename T> const Column<T>& columnAt(std::size_t col, std::string_view column) const;
+  template<typename T> const std::decay_t<T>& fetchDataRefAt(std::size_t col, std::string_view column) const;
+
+  // Tolerances and xfail flag set by the test function.
+  struct State
+  {
+    double abs_tol = DRTEST_ABS_TOL;
+    double rel_tol = DRTEST_REL_TOL;
+    bool xfail = false;
+  };
+  // Return the state of the row running on the calling thread: A copy
+  // of `state_` if the row is tagged `parallel`, `state_` otherwise.
+  State& state();
+  const State& state() const;
 
   // Add the elements of the tuple `t` specified by `Is...` to `row`.
   // Shall only be called from `addRow`.
   template<typename Tuple, std::size_t... Is> void addRowImpl(
       const std::string& row,
+      tags tag,
       Tuple t,
       const std::index_sequence<Is...>&
     );
   // Add `t` to the entry (`row`, `col`) of the data matrix. Shall only
   // be called from `addRow`.
-  template<typename T> void addRowImpl(const std::string& row, std::size_t col, T&& t);
+  template<typename T> void addRowImpl(std::size_t row, std::size_t col, T&& t);
 
   std::string name_{};
   std::vector<std::string> data_columns_{};
-  std::unordered_map<std::string, std::type_index> data_column_types_{};
+  std::vector<std::type_index> data_column_types_{};  // column index -> type
+  std::unordered_map<std::string, std::size_t> data_column_indices_{};
   std::vector<std::string> data_rows_{};
-  std::unordered_map<
-      std::string, // row
-      std::unordered_map<
-          std::string, // column
-          std::any
-        >> data_sets_{};
-  std::unordered_map<std::string, tags> tags_{};  // row -> tags
-  std::string current_row_{};
+  std::unordered_map<std::string, std::size_t> data_row_indices_{};
+  std::vector<std::any> data_sets_{};  // column index -> `Column<T>`
+  std::vector<tags> tags_{};  // row index -> tags
   std::function<void()> data_func_{};
   std::function<void()> test_func_{};
   std::vector<std::string> failed_rows_{};
+  std::vector<TestResult> results_{};
+
+  State state_{};
+  std::atomic<std::size_t>* spare_threads_ = nullptr;
 
-  double abs_tol_ = DRTEST_ABS_TOL;
-  double rel_tol_ = DRTEST_REL_TOL;
-  bool xfail_{false};
+  static thread_local TestObject* current_;
+  static thread_local std::size_t current_row_;
+  static thread_local State* row_state_;
 };
 
 }} // namespaces
@@ -29,11 +29,17 @@ template<typename T>
 void
 TestObject::addColumn(std::string column)
 {
-  data_columns_.push_back(column);
-  data_column_types_.insert({
-      std::move(column),
-      std::type_index(typeid(typename std::decay<T>::type))
-    });
+  using Type = std::decay_t<T>;
+  if (data_column_indices_.find(column) != data_column_indices_.end())
+  {
+    throw std::logic_error{
+        "adding column: \"" + column + "\"" + ": column already present"
+      };
+  }
+  data_column_indices_.insert({column, data_columns_.size()});
+  data_columns_.push_back(std::move(column));
+  data_column_types_.push_back(std::type_index(typeid(Type)));
+  data_sets_.push_back(Column<Type>{});
 }
 
 template<typename... Ts>
@@ -44,18 +50,18 @@ TestObject::addRow(const std::string& row, Ts&&... ts)
   if constexpr(std::is_same_v<drutility::last_t<Ts...>, tags>)
   {
     assert(size == (data_columns_.size() + 1));
-    tags_[row] = std::get<size-1>(std::forward_as_tuple(ts...));
     addRowImpl(
         row,
+        std::get<size-1>(std::forward_as_tuple(ts...)),
         std::forward_as_tuple(ts...),
         std::make_index_sequence<size - 1>{}
       );
   }
   else
   {
-    tags_[row] = tags::none;
     addRowImpl(
         row,
+        tags::none,
         std::forward_as_tuple(ts...),
         std::make_index_sequence<size>{}
       );
@@ -64,7 +70,12 @@ TestObject::addRow(const std::string& row, Ts&&... ts)
 
 template<typename Tuple, std::size_t... Is>
 void
-TestObject::addRowImpl(const std::string& row, Tuple t, const std::index_sequence<Is...>&)
+TestObject::addRowImpl(
+    const std::string& row,
+    tags tag,
+    Tuple t,
+    const std::index_sequence<Is...>&
+  )
 {
   constexpr auto size = sizeof...(Is);
   if (size > data_columns_.size())
@@ -81,67 +92,138 @@ TestObject::addRowImpl(const std::string& row, Tuple t, const std::index_sequenc
         "adding row: \"" + row + "\"" + ": empty string not allowed as row name"
       };
   }
-  if (std::find(data_rows_.begin(), data_rows_.end(), row) != data_rows_.end())
+  if (data_row_indices_.find(row) != data_row_indices_.end())
   {
     throw std::logic_error{
         "adding row: \"" + row + "\"" + ": row already present"
       };
   }
+
+  // Check all types before modifying the table.
+  std::size_t index = data_rows_.size();
+  (
+    [&] () {
+      const std::string& column = data_columns_[Is];
+      const std::type_index& expected_type = data_column_types_[Is];
+      const std::type_index actual_type = std::type_index(
+          typeid(std::decay_t<std::tuple_element_t<Is, Tuple>>)
+        );
+      if (actual_type != expected_type)
+      {
+        throw std::logic_error{
+            "adding row: \"" + row + "\", " +
+            "column: \"" + column + "\": " +
+            "type mismatch:\n" +
+            "  (actual) " + actual_type.name() + "\n" +
+            "  (expected) " + expected_type.name()
+          };
+      }
+    }(),
+    ...
+  );
+
   data_rows_.push_back(row);
-  (addRowImpl(row, Is, std::forward<std::tuple_element_t<Is, Tuple>>(std::get<Is>(t))),
+  data_row_indices_.insert({row, index});
+  tags_.push_back(tag);
+  (addRowImpl(index, Is, std::forward<std::tuple_element_t<Is, Tuple>>(std::get<Is>(t))),
    ...);
 }
 
 template<typename T>
 void
-TestObject::addRowImpl(const std::string& row, std::size_t col, T&& t)
+TestObject::addRowImpl(std::size_t row, std::size_t col, T&& t)
+{
+  auto& values = std::any_cast<Column<std::decay_t<T>>&>(data_sets_[col]);
+  values.resize(row);
+  values.emplace_back(std::forward<T>(t));
+}
+
+template<typename T>
+T
+TestObject::fetchData(const std::string& column) const
 {
-  const std::string& column = data_columns_[col];
-  auto type_it = data_column_types_.find(column);
-  if (type_it == data_column_types_.end())
+  return fetchDataRef<T>(column);
+}
+
+template<typename T>
+const std::decay_t<T>&
+TestObject::fetchDataRef(const std::string& column) const
+{
+  return fetchDataRefAt<T>(columnIndex(column), column);
+}
+
+template<typename T>
+T
+TestObject::fetchData(std::string_view column, ColumnCache& cache) const
+{
+  return fetchDataRef<T>(column, cache);
+}
+
+template<typename T>
+const std::decay_t<T>&
+TestObject::fetchDataRef(std::string_view column, ColumnCache& cache) const
+{
+  if (cache.test != this)
   {
-    throw std::logic_error{"internal error: no such column"};
+    cache.index = columnIndex(std::string{column});
+    cache.test = this;
   }
+  return fetchDataRefAt<T>(cache.index, column);
+}
 
-  const std::type_index& expected_type = std::get<std::type_index>(*type_it);
-  const std::type_index actual_type = std::type_index(typeid(typename std::decay<T>::type));
-  if (actual_type != expected_type)
+template<typename T>
+const std::decay_t<T>&
+TestObject::fetchCurrentRef(std::string_view column, ColumnCache& cache)
+{
+  const TestObject* test = current_;
+  if (not test)
   {
-    throw std::logic_error{
-        "adding row: \"" + row + "\", " +
-        "column: \"" + column + "\": " +
-        "type mismatch:\n" +
-        "  (actual) " + actual_type.name() + "\n" +
-        "  (expected) " + expected_type.name()
-      };
+    throw std::logic_error{"no test running"};
   }
-
-  data_sets_[row].insert({column, std::make_any<T>(std::forward<T>(t))});
+  return test->fetchDataRef<T>(column, cache);
 }
 
 template<typename T>
-T
-TestObject::fetchData(const std::string& column) const
+const std::decay_t<T>&
+TestObject::fetchDataRefAt(std::size_t col, std::string_view column) const
 {
-  if (current_row_.empty())
+  if (current_row_ >= data_rows_.size())
   {
     throw std::logic_error{"no data provided for test: " + name_};
   }
 
-  auto row_it = data_sets_.find(current_row_);
-  if (row_it == data_sets_.end())
+  const auto& values = columnAt<std::decay_t<T>>(col, column);
+  if (current_row_ >= values.size() or not values[current_row_])
   {
-    throw std::logic_error{"internal error: no such row: " + current_row_};
+    throw std::logic_error{
+        "no value in row: \"" + data_rows_[current_row_] + "\", column: " + std::string{column}
+      };
   }
-  auto& row = std::get<1>(*row_it);
+  return *values[current_row_];
+}
+
+template<typename T>
+const TestObject::Column<T>&
+TestObject::column(const std::string& column) const
+{
+  return columnAt<T>(columnIndex(column), column);
+}
 
-  auto value_it = row.find(column);
-  if (value_it == row.end())
+template<typename T>
+const TestObject::Column<T>&
+TestObject::columnAt(std::size_t col, std::string_view column) const
+{
+  auto values = std::any_cast<Column<T>>(&data_sets_[col]);
+  if (not values)
   {
-    throw std::logic_error{"no such column: " + column};
+    throw std::logic_error{
+        "fetching column: \"" + std::string{column} + "\": " +
+        "type mismatch:\n" +
+        "  (actual) " + typeid(T).name() + "\n" +
+        "  (expected) " + data_column_types_[col].name()
+      };
   }
-
-  return std::any_cast<T>(std::get<std::any>(*value_it));
+  return *values;
 }
 
 template<typename T>
@@ -151,8 +233,8 @@ TestObject::almostEqual(T actual, T expected) const
   return drutility::almost_equal(
       actual,
       expected,
-      static_cast<T>(abs_tol_),
-      static_cast<T>(rel_tol_)
+      static_cast<T>(state().abs_tol),
+      static_cast<T>(state().rel_tol)
     );
 }
 
@@ -0,0 +1,259 @@
+/* Copyright 2021 Ole Kliemann, Malte Kliemann
+ *
+ * This file is part of DrMock.
+ *
+ * DrMock is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DrMock is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DrMock.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "AsyncLogger.h"
+
+#ifdef _MSC_VER
+#include <ciso646>
+#endif /* _MSC_VER */
+
+#ifndef _WIN32
+#include <pthread.h>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <sstream>
+
+#include <DrMock/utility/Logger.h>
+
+namespace drutility {
+
+namespace {
+
+std::size_t
+roundUpToPowerOfTwo(std::size_t n)
+{
+  std::size_t result = 1;
+  while (result < n)
+  {
+    result <<= 1;
+  }
+  return result;
+}
+
+// Number of `fork`s between the start of the program and the calling
+// process. Counted by an atfork handler, so that checking whether a
+// logger was inherited from the parent doesn't require a syscall.
+std::atomic<unsigned> num_forks{0};
+
+unsigned
+numForks()
+{
+#ifndef _WIN32
+  static const bool registered = [] () {
+      pthread_atfork(nullptr, nullptr, [] () {
+          num_forks.fetch_add(1, std::memory_order_relaxed);
+        });
+      return true;
+    }();
+  static_cast<void>(registered);
+#endif
+  return num_forks.load(std::memory_order_relaxed);
+}
+
+// Time after which a sleeping writer checks the buffer even if it wasn't
+// woken.
+constexpr std::chrono::milliseconds poll_interval{10};
+
+} // anonymous namespace
+
+AsyncLogger::AsyncLogger(Policy policy, std::size_t capacity, std::ostream& os)
+:
+  policy_{policy},
+  mask_{roundUpToPowerOfTwo(std::max(capacity, std::size_t{2})) - 1},
+  slots_{new Slot[mask_ + 1]},
+  out_stream_{os.rdbuf()},
+  forks_{numForks()}
+{
+  for (std::size_t i = 0; i <= mask_; ++i)
+  {
+    slots_[i].sequence.store(i, std::memory_order_relaxed);
+  }
+  writer_ = std::make_unique<std::thread>([this] () { run(); });
+}
+
+AsyncLogger::~AsyncLogger()
+{
+  if (forked())
+  {
+    // The writer thread does not exist in the child process.
+    writer_.release();
+    return;
+  }
+  stop_ = true;
+  wake();
+  writer_->join();
+}
+
+void
+AsyncLogger::logMessage(
+    bool timestamp,
+    const std::string& category,
+    const std::string& location,
+    int line,
+    const std::ostream& msg
+  )
+{
+  if (forked())
+  {
+    return;
+  }
+
+  std::string formatted = Logger::format(timestamp, category, location, line, msg);
+  formatted += '\n';
+  while (not tryPush(formatted))
+  {
+    if (policy_ == Policy::drop)
+    {
+      ++dropped_;
+      return;
+    }
+    wake();
+    std::this_thread::yield();
+  }
+  wake();
+}
+
+void
+AsyncLogger::flush()
+{
+  if (forked())
+  {
+    return;
+  }
+
+  // Every message logged before the call has claimed one of the slots
+  // before `head_` (dropped messages don't claim a slot).
+  std::size_t target = head_.load();
+  std::unique_lock lck{mtx_};
+  wake_cv_.notify_one();
+  written_cv_.wait(lck, [&] () { return written_.load() >= target; });
+}
+
+bool
+AsyncLogger::tryPush(std::string& msg)
+{
+  std::size_t pos = head_.load(std::memory_order_relaxed);
+  while (true)
+  {
+    Slot& slot = slots_[pos & mask_];
+    std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+    if (sequence == pos)
+    {
+      if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+      {
+        slot.msg = std::move(msg);
+        slot.sequence.store(pos + 1, std::memory_order_release);
+        return true;
+      }
+    }
+    else if (sequence < pos)
+    {
+      return false;  // The slot still holds the message of the previous lap.
+    }
+    else
+    {
+      pos = head_.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+bool
+AsyncLogger::tryPop(std::string& msg)
+{
+  Slot& slot = slots_[tail_ & mask_];
+  if (slot.sequence.load(std::memory_order_acquire) != tail_ + 1)
+  {
+    return false;
+  }
+  msg.swap(slot.msg);
+  slot.msg.clear();
+  slot.sequence.store(tail_ + mask_ + 1, std::memory_order_release);
+  ++tail_;
+  return true;
+}
+
+void
+AsyncLogger::run()
+{
+  std::string batch{};
+  std::string msg{};
+  while (true)
+  {
+    std::size_t num_popped = 0;
+    batch.clear();
+    while (tryPop(msg))
+    {
+      batch += msg;
+      ++num_popped;
+    }
+    std::size_t dropped = dropped_.exchange(0);
+    if (dropped > 0)
+    {
+      batch += Logger::format(
+          false,
+          "WARN",
+          "AsyncLogger",
+          -1,
+          std::stringstream{} << dropped << " messages dropped"
+        ) + '\n';
+    }
+    if (not batch.empty())
+    {
+      out_stream_.write(batch.data(), static_cast<std::streamsize>(batch.size()));
+      out_stream_.flush();
+    }
+    if (num_popped > 0)
+    {
+      std::lock_guard lck{mtx_};
+      written_ += num_popped;
+      written_cv_.notify_all();
+      continue;
+    }
+
+    if (stop_)
+    {
+      return;
+    }
+    std::unique_lock lck{mtx_};
+    sleeping_ = true;
+    wake_cv_.wait_for(lck, poll_interval, [&] () {
+        return stop_.load() or (written_.load() != head_.load());
+      });
+    sleeping_ = false;
+  }
+}
+
+void
+AsyncLogger::wake()
+{
+  if (sleeping_.load())
+  {
+    std::lock_guard lck{mtx_};
+    wake_cv_.notify_one();
+  }
+}
+
+bool
+AsyncLogger::forked() const
+{
+  return num_forks.load(std::memory_order_relaxed) != forks_;
+}
+
+} // namespace drutility
@@ -0,0 +1,119 @@
+/* Copyright 2021 Ole Kliemann, Malte Kliemann
+ *
+ * This file is part of DrMock.
+ *
+ * DrMock is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DrMock is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DrMock.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef DRMOCK_SRC_DRMOCK_UTILITY_ASYNCLOGGER_H
+#define DRMOCK_SRC_DRMOCK_UTILITY_ASYNCLOGGER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <DrMock/utility/ILogger.h>
+
+namespace drutility {
+
+/**
+ * Logger which formats messages on the calling thread and writes them
+ * to the output stream on a background thread.
+ *
+ * Messages are passed to the writer through a lock-free ring buffer of
+ * fixed capacity. If the buffer is full, `logMessage` either waits
+ * until the writer has made room (`Policy::block`) or discards the
+ * message (`Policy::drop`); the number of discarded messages is
+ * reported in the log.
+ *
+ * The output has the same format as that of `Logger`. Messages logged
+ * by the child of a `fork` are discarded.
+ */
+class AsyncLogger : public ILogger
+{
+public:
+  enum class Policy
+  {
+    block,
+    drop
+  };
+
+  /**
+   * @param policy What to do if the buffer is full
+   * @param capacity The number of messages the buffer can hold; is
+   * rounded up to a power of two
+   * @param os The output stream
+   */
+  AsyncLogger(
+      Policy policy = Policy::block,
+      std::size_t capacity = 4096,
+      std::ostream& os = std::cout
+    );
+  ~AsyncLogger();
+
+  AsyncLogger(const AsyncLogger&) = delete;
+  AsyncLogger& operator=(const AsyncLogger&) = delete;
+
+  void logMessage(
+      bool timestamp,
+      const std::string& category,
+      const std::string& location,
+      int line,
+      const std::ostream& msg
+    ) override final;
+
+  /**
+   * Block until every message logged before the call is written.
+   */
+  void flush();
+
+private:
+  struct Slot
+  {
+    std::atomic<std::size_t> sequence;
+    std::string msg;
+  };
+
+  bool tryPush(std::string& msg);
+  bool tryPop(std::string& msg);
+  void run();
+  void wake();
+  bool forked() const;
+
+  Policy policy_;
+  std::size_t mask_;
+  std::unique_ptr<Slot[]> slots_;
+  std::atomic<std::size_t> head_{0};  // Next slot to push to
+  std::size_t tail_ = 0;  // Next slot to pop from; only used by the writer
+  std::atomic<std::size_t> written_{0};
+  std::atomic<std::size_t> dropped_{0};
+  std::atomic<bool> sleeping_{false};
+  std::atomic<bool> stop_{false};
+  std::ostream out_stream_;
+
+  std::mutex mtx_{};
+  std::condition_variable wake_cv_{};
+  std::condition_variable written_cv_{};
+
+  unsigned forks_;  // Value of `numForks()` at construction
+  std::unique_ptr<std::thread> writer_;
+};
+
+} // namespace drutility
+
+#endif /* DRMOCK_SRC_DRMOCK_UTILITY_ASYNCLOGGER_H */
@@ -0,0 +1,82 @@
+/* Copyright 2021 Ole Kliemann, Malte Kliemann
+ *
+ * This file is part of DrMock.
+ *
+ * DrMock is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DrMock is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DrMock.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "BufferingLogger.h"
+
+#include <sstream>
+#include <utility>
+
+namespace drutility {
+
+thread_local BufferingLogger::Buffer* BufferingLogger::buffer_ = nullptr;
+
+BufferingLogger::BufferingLogger(std::shared_ptr<ILogger> logger)
+:
+  logger_{std::move(logger)}
+{}
+
+void
+BufferingLogger::logMessage(
+    bool timestamp,
+    const std::string& category,
+    const std::string& location,
+    int line,
+    const std::ostream& msg
+  )
+{
+  if (not buffer_)
+  {
+    logger_->logMessage(timestamp, category, location, line, msg);
+    return;
+  }
+
+  std::stringstream s{};
+  if (msg.rdbuf()->in_avail())
+  {
+    s << msg.rdbuf();
+  }
+  buffer_->push_back({timestamp, category, location, line, s.str()});
+}
+
+void
+BufferingLogger::replay(const Buffer& buffer)
+{
+  if (buffer_)
+  {
+    buffer_->insert(buffer_->end(), buffer.begin(), buffer.end());
+    return;
+  }
+  for (const auto& m : buffer)
+  {
+    logger_->logMessage(
+        m.timestamp,
+        m.category,
+        m.location,
+        m.line,
+        std::stringstream{} << m.msg
+      );
+  }
+}
+
+BufferingLogger::Buffer*
+BufferingLogger::capture(Buffer* buffer)
+{
+  return std::exchange(buffer_, buffer);
+}
+
+} // namespace drutility
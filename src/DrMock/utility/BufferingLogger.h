@@ -0,0 +1,82 @@
+/* Copyright 2021 Ole Kliemann, Malte Kliemann
+ *
+ * This file is part of DrMock.
+ *
+ * DrMock is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DrMock is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DrMock.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef DRMOCK_SRC_DRMOCK_UTILITY_BUFFERINGLOGGER_H
+#define DRMOCK_SRC_DRMOCK_UTILITY_BUFFERINGLOGGER_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <DrMock/utility/ILogger.h>
+
+namespace drutility {
+
+/**
+ * Decorator for `ILogger` which diverts the messages logged by a
+ * thread into a buffer while the thread has a buffer installed.
+ *
+ * Messages logged by threads without a buffer are forwarded to the
+ * wrapped logger. Buffered messages are forwarded using `replay`.
+ */
+class BufferingLogger : public ILogger
+{
+public:
+  struct Message
+  {
+    bool timestamp;
+    std::string category;
+    std::string location;
+    int line;
+    std::string msg;
+  };
+  using Buffer = std::vector<Message>;
+
+  /**
+   * @param logger The wrapped logger
+   */
+  BufferingLogger(std::shared_ptr<ILogger> logger);
+
+  void logMessage(
+      bool timestamp,
+      const std::string& category,
+      const std::string& location,
+      int line,
+      const std::ostream& msg
+    ) override final;
+
+  /**
+   * Forward the messages of `buffer` as if they were logged by the
+   * calling thread.
+   */
+  void replay(const Buffer& buffer);
+
+  /**
+   * Install `buffer` for the calling thread and return the previously
+   * installed buffer; pass `nullptr` to uninstall.
+   */
+  static Buffer* capture(Buffer* buffer);
+
+private:
+  std::shared_ptr<ILogger> logger_;
+  static thread_local Buffer* buffer_;
+};
+
+} // namespace drutility
+
+#endif /* DRMOCK_SRC_DRMOCK_UTILITY_BUFFERINGLOGGER_H */
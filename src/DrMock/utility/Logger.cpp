@@ -24,6 +24,7 @@
 
 #include <algorithm>
 #include <iostream>
+#include <sstream>
 
 namespace drutility {
 
@@ -41,38 +42,52 @@ Logger::logMessage(
     const std::ostream& msg
   )
 {
+  std::string formatted = format(timestamp, category, location, line, msg);
   std::lock_guard lck{mtx_};
+  out_stream_ << formatted << std::endl;
+}
+
+std::string
+Logger::format(
+    bool timestamp,
+    const std::string& category,
+    const std::string& location,
+    int line,
+    const std::ostream& msg
+  )
+{
+  std::stringstream result{};
   bool written = false;
   if (timestamp)
   {
-    out_stream_ << mkTimestamp();
+    result << mkTimestamp();
     written = true;
   }
   if (not category.empty())
   {
-    out_stream_ << category.substr(0, 6)
-                << std::string(7 - std::min(category.size(), std::size_t{6}), ' ');
+    result << category.substr(0, 6)
+           << std::string(7 - std::min(category.size(), std::size_t{6}), ' ');
     written = true;
   }
   if (not location.empty())
   {
-    out_stream_ << location;
+    result << location;
     written = true;
   }
   if (line > 0)
   {
-    out_stream_ << " (" << line << ")";
+    result << " (" << line << ")";
     written = true;
   }
   if (msg.rdbuf()->in_avail())
   {
     if (written)
     {
-      out_stream_ << ": ";
+      result << ": ";
     }
-    out_stream_ << msg.rdbuf();
+    result << msg.rdbuf();
   }
-  out_stream_ << std::endl;
+  return result.str();
 }
 
 std::string
@@ -20,6 +20,7 @@
 #define DRMOCK_SRC_DRMOCK_UTILITY_LOGGER_H
 
 #include <mutex>
+#include <string>
 
 #include <DrMock/utility/ILogger.h>
 
@@ -37,8 +38,19 @@ public:
       const std::ostream& msg
     ) override final;
 
+  /**
+   * Return the line written by `logMessage` (without line break).
+   */
+  static std::string format(
+      bool timestamp,
+      const std::string& category,
+      const std::string& location,
+      int line,
+      const std::ostream& msg
+    );
+
 private:
-  std::string mkTimestamp();
+  static std::string mkTimestamp();
 
   std::mutex mtx_{};
   std::ostream out_stream_;
@@ -0,0 +1,57 @@
+/* Copyright 2021 Ole Kliemann, Malte Kliemann
+ *
+ * This file is part of DrMock.
+ *
+ * DrMock is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DrMock is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DrMock.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef DRMOCK_SRC_DRMOCK_UTILITY_DETAIL_SCOPEGUARD_H
+#define DRMOCK_SRC_DRMOCK_UTILITY_DETAIL_SCOPEGUARD_H
+
+#include <utility>
+
+namespace drutility { namespace detail {
+
+/* ScopeGuard
+
+Calls `f` on destruction, unless dismissed. Used for cleaning up on the
+error path of a function.
+*/
+
+template<typename F>
+class ScopeGuard
+{
+public:
+  ScopeGuard(F f) : f_{std::move(f)} {}
+  ~ScopeGuard()
+  {
+    if (active_)
+    {
+      f_();
+    }
+  }
+
+  ScopeGuard(const ScopeGuard&) = delete;
+  ScopeGuard& operator=(const ScopeGuard&) = delete;
+
+  void dismiss() { active_ = false; }
+
+private:
+  F f_;
+  bool active_ = true;
+};
+
+}} // namespace drutility::detail
+
+#endif /* DRMOCK_SRC_DRMOCK_UTILITY_DETAIL_SCOPEGUARD_H */
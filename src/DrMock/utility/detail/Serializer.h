@@ -0,0 +1,246 @@
+/* Copyright 2021 Ole Kliemann, Malte Kliemann
+ *
+ * This file is part of DrMock.
+ *
+ * DrMock is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DrMock is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DrMock.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef DRMOCK_SRC_DRMOCK_UTILITY_DETAIL_SERIALIZER_H
+#define DRMOCK_SRC_DRMOCK_UTILITY_DETAIL_SERIALIZER_H
+
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace drutility { namespace detail {
+
+/* Serializer
+
+Class template with static methods
+
+  static void write(std::string& buffer, const T& value);
+  static T read(const char*& pos, const char* end);
+
+which append `value` in binary format to `buffer`, or read a value from
+`[pos, end)` and advance `pos` past it (throwing `std::runtime_error`
+if the range is too short). Used by `drmock::Recorder` and
+`drmock::Replay`.
+
+Serializers are defined for arithmetic and enum types, `std::string`,
+and `std::vector`, `std::optional`, `std::pair` and `std::tuple` of
+serializable types. Like `TypeInfo`, `Serializer` may be specialized for
+other types:
+
+  namespace drutility { namespace detail {
+  template<>
+  struct Serializer<Point>
+  {
+    static constexpr bool is_defined() { return true; }
+    static void write(std::string& buffer, const Point& p) { ... }
+    static Point read(const char*& pos, const char* end) { ... }
+  };
+  }}
+
+The format is the memory layout of the host, so data should only be
+read on the platform that wrote it.
+*/
+
+template<typename T, typename = void>
+struct Serializer
+{
+  static constexpr bool is_defined()
+  {
+    return false;
+  }
+};
+
+template<typename... Ts>
+inline constexpr bool is_serializable_v = (Serializer<std::decay_t<Ts>>::is_defined() and ...);
+
+// Advance `pos` by `size` and return its old value.
+inline const char*
+readBytes(const char*& pos, const char* end, std::size_t size)
+{
+  if (static_cast<std::size_t>(end - pos) < size)
+  {
+    throw std::runtime_error{"Serializer: unexpected end of data"};
+  }
+  auto result = pos;
+  pos += size;
+  return result;
+}
+
+template<typename T>
+struct Serializer<T, std::enable_if_t<(std::is_arithmetic_v<T> and not std::is_same_v<T, bool>) or std::is_enum_v<T>>>
+{
+  static constexpr bool is_defined()
+  {
+    return true;
+  }
+  static void write(std::string& buffer, const T& value)
+  {
+    buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+  static T read(const char*& pos, const char* end)
+  {
+    T result;
+    std::memcpy(&result, readBytes(pos, end, sizeof(T)), sizeof(T));
+    return result;
+  }
+};
+
+// Not every byte is a valid `bool`, so `bool` is stored as one
+// `std::uint8_t` and checked when read.
+template<>
+struct Serializer<bool>
+{
+  static constexpr bool is_defined()
+  {
+    return true;
+  }
+  static void write(std::string& buffer, bool value)
+  {
+    Serializer<std::uint8_t>::write(buffer, value ? 1 : 0);
+  }
+  static bool read(const char*& pos, const char* end)
+  {
+    auto byte = Serializer<std::uint8_t>::read(pos, end);
+    if (byte > 1)
+    {
+      throw std::runtime_error{"Serializer: invalid bool"};
+    }
+    return byte == 1;
+  }
+};
+
+template<>
+struct Serializer<std::string>
+{
+  static constexpr bool is_defined()
+  {
+    return true;
+  }
+  static void write(std::string& buffer, const std::string& value)
+  {
+    Serializer<std::uint64_t>::write(buffer, value.size());
+    buffer.append(value);
+  }
+  static std::string read(const char*& pos, const char* end)
+  {
+    auto size = Serializer<std::uint64_t>::read(pos, end);
+    auto data = readBytes(pos, end, size);
+    return std::string(data, size);
+  }
+};
+
+template<typename T>
+struct Serializer<std::vector<T>, std::enable_if_t<is_serializable_v<T>>>
+{
+  static constexpr bool is_defined()
+  {
+    return true;
+  }
+  static void write(std::string& buffer, const std::vector<T>& value)
+  {
+    Serializer<std::uint64_t>::write(buffer, value.size());
+    for (const auto& x : value)
+    {
+      Serializer<T>::write(buffer, x);
+    }
+  }
+  static std::vector<T> read(const char*& pos, const char* end)
+  {
+    auto size = Serializer<std::uint64_t>::read(pos, end);
+    std::vector<T> result{};
+    for (std::uint64_t i = 0; i < size; ++i)
+    {
+      result.push_back(Serializer<T>::read(pos, end));
+    }
+    return result;
+  }
+};
+
+template<typename T>
+struct Serializer<std::optional<T>, std::enable_if_t<is_serializable_v<T>>>
+{
+  static constexpr bool is_defined()
+  {
+    return true;
+  }
+  static void write(std::string& buffer, const std::optional<T>& value)
+  {
+    Serializer<bool>::write(buffer, value.has_value());
+    if (value)
+    {
+      Serializer<T>::write(buffer, *value);
+    }
+  }
+  static std::optional<T> read(const char*& pos, const char* end)
+  {
+    if (not Serializer<bool>::read(pos, end))
+    {
+      return std::nullopt;
+    }
+    return Serializer<T>::read(pos, end);
+  }
+};
+
+template<typename T, typename U>
+struct Serializer<std::pair<T, U>, std::enable_if_t<is_serializable_v<T, U>>>
+{
+  static constexpr bool is_defined()
+  {
+    return true;
+  }
+  static void write(std::string& buffer, const std::pair<T, U>& value)
+  {
+    Serializer<T>::write(buffer, value.first);
+    Serializer<U>::write(buffer, value.second);
+  }
+  static std::pair<T, U> read(const char*& pos, const char* end)
+  {
+    auto first = Serializer<T>::read(pos, end);
+    return {std::move(first), Serializer<U>::read(pos, end)};
+  }
+};
+
+template<typename... Ts>
+struct Serializer<std::tuple<Ts...>, std::enable_if_t<is_serializable_v<Ts...>>>
+{
+  static constexpr bool is_defined()
+  {
+    return true;
+  }
+  static void write(std::string& buffer, const std::tuple<Ts...>& value)
+  {
+    std::apply(
+        [&buffer] (const auto&... xs) { (Serializer<Ts>::write(buffer, xs), ...); },
+        value
+      );
+  }
+  static std::tuple<Ts...> read([[maybe_unused]] const char*& pos, [[maybe_unused]] const char* end)
+  {
+    // Braced initialization guarantees left-to-right evaluation.
+    return std::tuple<Ts...>{Serializer<Ts>::read(pos, end)...};
+  }
+};
+
+}} // namespace drutility::detail
+
+#endif /* DRMOCK_SRC_DRMOCK_UTILITY_DETAIL_SERIALIZER_H */
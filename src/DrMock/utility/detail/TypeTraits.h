@@ -19,9 +19,23 @@
 #ifndef DRMOCK_SRC_DRMOCK_UTILITY_DETAIL_TYPETRAITS_H
 #define DRMOCK_SRC_DRMOCK_UTILITY_DETAIL_TYPETRAITS_H
 
+#include <array>
+#include <deque>
+#include <forward_list>
 #include <functional>
+#include <list>
+#include <map>
 #include <memory>
+#include <optional>
+#include <set>
+#include <string>
+#include <tuple>
 #include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <variant>
+#include <vector>
 
 namespace drutility { namespace detail {
 
@@ -61,6 +75,105 @@ struct is_output_streamable<
     std::void_t<decltype(std::declval<std::ostream&>() << std::declval<const T&>())>
  > : std::true_type {};
 
+template<typename T, typename = std::void_t<>>
+struct is_hashable : std::false_type {};
+
+template<typename T>
+struct is_hashable<
+    T,
+    std::void_t<decltype(std::declval<const std::hash<T>&>()(std::declval<const T&>()))>
+  > : std::is_default_constructible<std::hash<T>> {};
+
+template<typename T>
+inline constexpr bool is_hashable_v = is_hashable<T>::value;
+
+/* is_self_contained
+
+True if a copy of `T` owns everything it refers to, so that the copy
+may be used after the original and everything it points into is gone.
+This is an allow-list: arithmetic and enum types, `std::basic_string`,
+and the standard containers (with the default allocator, comparator and
+hash), `std::pair`, `std::tuple`, `std::optional` and `std::variant`
+whose element types are self-contained. Everything else (pointers,
+views, iterators, smart pointers and user-defined types, which may hold
+any of these) is assumed to refer to objects it doesn't own.
+
+User-defined types may be added to the allow-list by specializing
+`is_self_contained`:
+
+  namespace drutility { namespace detail {
+  template<>
+  struct is_self_contained<Point> : std::true_type {};
+  }}
+*/
+
+template<typename T>
+struct is_self_contained : std::disjunction<std::is_arithmetic<T>, std::is_enum<T>> {};
+
+template<typename T>
+inline constexpr bool is_self_contained_v = is_self_contained<std::remove_cv_t<T>>::value;
+
+template<typename CharT>
+struct is_self_contained<std::basic_string<CharT>> : std::true_type {};
+
+template<typename T>
+struct is_self_contained<std::vector<T>> : std::bool_constant<is_self_contained_v<T>> {};
+
+template<typename T>
+struct is_self_contained<std::deque<T>> : std::bool_constant<is_self_contained_v<T>> {};
+
+template<typename T>
+struct is_self_contained<std::list<T>> : std::bool_constant<is_self_contained_v<T>> {};
+
+template<typename T>
+struct is_self_contained<std::forward_list<T>> : std::bool_constant<is_self_contained_v<T>> {};
+
+template<typename T, std::size_t N>
+struct is_self_contained<std::array<T, N>> : std::bool_constant<is_self_contained_v<T>> {};
+
+template<typename T>
+struct is_self_contained<std::set<T>> : std::bool_constant<is_self_contained_v<T>> {};
+
+template<typename T>
+struct is_self_contained<std::multiset<T>> : std::bool_constant<is_self_contained_v<T>> {};
+
+template<typename T>
+struct is_self_contained<std::unordered_set<T>> : std::bool_constant<is_self_contained_v<T>> {};
+
+template<typename T>
+struct is_self_contained<std::unordered_multiset<T>> : std::bool_constant<is_self_contained_v<T>> {};
+
+template<typename K, typename V>
+struct is_self_contained<std::map<K, V>>
+  : std::bool_constant<is_self_contained_v<K> and is_self_contained_v<V>> {};
+
+template<typename K, typename V>
+struct is_self_contained<std::multimap<K, V>>
+  : std::bool_constant<is_self_contained_v<K> and is_self_contained_v<V>> {};
+
+template<typename K, typename V>
+struct is_self_contained<std::unordered_map<K, V>>
+  : std::bool_constant<is_self_contained_v<K> and is_self_contained_v<V>> {};
+
+template<typename K, typename V>
+struct is_self_contained<std::unordered_multimap<K, V>>
+  : std::bool_constant<is_self_contained_v<K> and is_self_contained_v<V>> {};
+
+template<typename T, typename U>
+struct is_self_contained<std::pair<T, U>>
+  : std::bool_constant<is_self_contained_v<T> and is_self_contained_v<U>> {};
+
+template<typename... Ts>
+struct is_self_contained<std::tuple<Ts...>>
+  : std::bool_constant<(is_self_contained_v<Ts> and ...)> {};
+
+template<typename T>
+struct is_self_contained<std::optional<T>> : std::bool_constant<is_self_contained_v<T>> {};
+
+template<typename... Ts>
+struct is_self_contained<std::variant<Ts...>>
+  : std::bool_constant<(is_self_contained_v<Ts> and ...)> {};
+
 template<typename T1, typename T2>
 struct is_base_of_smart_ptr
 {
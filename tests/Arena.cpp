@@ -0,0 +1,93 @@
+/* Copyright 2021 Ole Kliemann, Malte Kliemann
+ *
+ * This file is part of DrMock.
+ *
+ * DrMock is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DrMock is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DrMock.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <DrMock/Test.h>
+#include <DrMock/mock/Method.h>
+#include <DrMock/mock/StateObject.h>
+#include <DrMock/mock/detail/Arena.h>
+
+using namespace drmock;
+using namespace drmock::detail;
+
+DRTEST_TEST(allocate)
+{
+  Arena arena{};
+  DRTEST_ASSERT_EQ(arena.capacity(), std::size_t{0});
+  auto p = arena.allocate(1, 1);
+  auto q = arena.allocate(8, 8);
+  DRTEST_ASSERT(p);
+  DRTEST_ASSERT_EQ(reinterpret_cast<std::uintptr_t>(q) % 8, std::uintptr_t{0});
+  DRTEST_ASSERT(static_cast<char*>(q) > static_cast<char*>(p));
+  auto capacity = arena.capacity();
+  DRTEST_ASSERT(capacity >= 9);
+
+  // Large allocations get a chunk of their own.
+  auto r = arena.allocate(100000, 64);
+  DRTEST_ASSERT_EQ(reinterpret_cast<std::uintptr_t>(r) % 64, std::uintptr_t{0});
+  DRTEST_ASSERT(arena.capacity() >= capacity + 100000);
+}
+
+DRTEST_TEST(allocator)
+{
+  auto arena = std::make_shared<Arena>();
+  {
+    std::vector<std::string, ArenaAllocator<std::string>> v{ArenaAllocator<std::string>{arena}};
+    for (int i = 0; i < 1000; ++i)
+    {
+      v.push_back(std::to_string(i));
+    }
+    DRTEST_ASSERT_EQ(v[999], "999");
+    DRTEST_ASSERT(arena->capacity() >= 1000*sizeof(std::string));
+  }
+
+  // Allocations keep the arena alive.
+  auto p = allocateShared<std::string>(arena, "foo");
+  std::weak_ptr<Arena> weak = arena;
+  arena.reset();
+  DRTEST_ASSERT(not weak.expired());
+  DRTEST_ASSERT_EQ(*p, "foo");
+  p.reset();
+  DRTEST_ASSERT(weak.expired());
+
+  // Without arena, the heap is used.
+  auto q = allocateShared<std::string>(nullptr, "bar");
+  DRTEST_ASSERT_EQ(*q, "bar");
+}
+
+DRTEST_TEST(method)
+{
+  class Dummy {};
+  auto state_object = std::make_shared<StateObject>();
+  Method<Dummy, std::string, int, std::string> m{state_object};
+  for (int i = 0; i < 1000; ++i)
+  {
+    m.push().expects(i, "foo").returns(std::to_string(i));
+  }
+  // Behaviors, matchers and return values are taken from the arena.
+  DRTEST_ASSERT(state_object->arena()->capacity() >= 1000*(2*sizeof(std::string)));
+  for (int i = 0; i < 1000; ++i)
+  {
+    DRTEST_ASSERT_EQ(*m.call(i, "foo"), std::to_string(i));
+  }
+  DRTEST_ASSERT(m.verify());
+}
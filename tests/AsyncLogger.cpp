@@ -0,0 +1,150 @@
+/* Copyright 2021 Ole Kliemann, Malte Kliemann
+ *
+ * This file is part of DrMock.
+ *
+ * DrMock is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DrMock is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DrMock.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _WIN32
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <DrMock/Test.h>
+#include <DrMock/utility/AsyncLogger.h>
+
+using namespace drutility;
+
+// Log `n` messages from each of `num_threads` threads.
+void logConcurrently(ILogger& logger, int num_threads, int n)
+{
+  std::vector<std::thread> threads{};
+  for (int k = 0; k < num_threads; ++k)
+  {
+    threads.emplace_back([&logger, k, n] () {
+        for (int i = 1; i <= n; ++i)
+        {
+          logger.logMessage(false, "INFO", std::to_string(k), i, std::stringstream{} << "msg");
+        }
+      });
+  }
+  for (auto& thread : threads)
+  {
+    thread.join();
+  }
+}
+
+std::vector<std::string> lines(const std::string& s)
+{
+  std::vector<std::string> result{};
+  std::stringstream ss{s};
+  for (std::string line; std::getline(ss, line); )
+  {
+    result.push_back(line);
+  }
+  return result;
+}
+
+DRTEST_TEST(format)
+{
+  std::stringstream out{};
+  AsyncLogger logger{AsyncLogger::Policy::block, 4, out};
+  logger.logMessage(false, "CATEGORY", "location", 12, std::stringstream{} << "message");
+  logger.logMessage(false, "", "", -1, std::stringstream{} << "plain");
+  logger.flush();
+  DRTEST_ASSERT_EQ(out.str(), std::string{"CATEGO location (12): message\nplain\n"});
+}
+
+DRTEST_TEST(block)
+{
+  std::stringstream out{};
+  AsyncLogger logger{AsyncLogger::Policy::block, 8, out};
+  logConcurrently(logger, 4, 1000);
+  logger.flush();
+
+  // Every message is written and the messages of each thread are in
+  // order.
+  auto result = lines(out.str());
+  DRTEST_ASSERT_EQ(result.size(), 4000u);
+  std::vector<int> next(4, 1);
+  for (const auto& line : result)
+  {
+    int k = line[7] - '0';
+    DRTEST_ASSERT_EQ(line, "INFO   " + std::to_string(k) + " (" + std::to_string(next[k]) + "): msg");
+    ++next[k];
+  }
+}
+
+DRTEST_TEST(drop)
+{
+  std::stringstream out{};
+  {
+    AsyncLogger logger{AsyncLogger::Policy::drop, 2, out};
+    logConcurrently(logger, 4, 1000);
+  }
+
+  // The number of messages written plus the number of reported drops
+  // is the number of messages logged.
+  std::size_t written = 0;
+  std::size_t dropped = 0;
+  for (const auto& line : lines(out.str()))
+  {
+    std::string prefix = "WARN   AsyncLogger: ";
+    if (line.rfind(prefix, 0) == 0)
+    {
+      dropped += std::stoul(line.substr(prefix.size()));
+    }
+    else
+    {
+      ++written;
+    }
+  }
+  DRTEST_ASSERT_EQ(written + dropped, 4000u);
+}
+
+#ifndef _WIN32
+DRTEST_TEST(childOfFork)
+{
+  std::stringstream out{};
+  AsyncLogger logger{AsyncLogger::Policy::block, 2, out};
+  logger.logMessage(false, "", "", -1, std::stringstream{} << "parent");
+  logger.flush();
+
+  // The child has no writer; if it didn't detect the fork, it would
+  // block once the buffer is full.
+  pid_t pid = fork();
+  if (pid == 0)
+  {
+    for (int i = 0; i < 100; ++i)
+    {
+      logger.logMessage(false, "", "", -1, std::stringstream{} << "child");
+    }
+    logger.flush();
+    _exit(0);
+  }
+  int status = 0;
+  DRTEST_ASSERT_EQ(waitpid(pid, &status, 0), pid);
+  DRTEST_ASSERT(WIFEXITED(status));
+  DRTEST_ASSERT_EQ(WEXITSTATUS(status), 0);
+
+  logger.logMessage(false, "", "", -1, std::stringstream{} << "parent");
+  logger.flush();
+  DRTEST_ASSERT_EQ(out.str(), std::string{"parent\nparent\n"});
+}
+#endif /* _WIN32 */
@@ -16,6 +16,7 @@
  * along with DrMock.  If not, see <https://www.gnu.org/licenses/>.
 */
 
+#include <optional>
 #include <string>
 
 #include <DrMock/Test.h>
@@ -37,10 +38,7 @@ public:
 };
 
 template<typename ReturnType>
-using Result = std::pair<
-    std::shared_ptr<ReturnType>,
-    std::shared_ptr<AbstractSignal<Dummy>>
-  >;
+using Result = std::pair<ReturnType*, AbstractSignal<Dummy>*>;
 
 DRTEST_TEST(exhausted)
 {
@@ -479,3 +477,112 @@ DRTEST_TEST(convenienceExpectPolymorphic)
       );
   }
 }
+
+DRTEST_TEST(hash)
+{
+  {
+    Behavior<Dummy, void, int, std::string> b{};
+    DRTEST_ASSERT(not b.hash());
+    b.expects(1, "foo");
+    DRTEST_ASSERT(b.hash());
+    DRTEST_ASSERT_EQ(*b.hash(), detail::hashAll(1, std::string{"foo"}));
+  }
+
+  {
+    Behavior<Dummy, void, int, float> b{};
+    b.expects(1, almost_equal(1.0f));
+    DRTEST_ASSERT(not b.hash());
+  }
+
+  {
+    Behavior<Dummy, void, std::shared_ptr<Base>> b{};
+    b.expects(std::make_shared<Derived>(1, 2));
+    DRTEST_ASSERT(not b.hash());
+  }
+}
+
+DRTEST_TEST(isStub)
+{
+  {
+    Behavior<Dummy, int, int> b{};
+    b.expects().returns(1);
+    DRTEST_ASSERT(not b.is_stub());
+    b.persists();
+    DRTEST_ASSERT(b.is_stub());
+  }
+
+  {
+    Behavior<Dummy, int, int> b{};
+    b.expects(1).returns(1).persists();
+    DRTEST_ASSERT(not b.is_stub());
+  }
+
+  {
+    Behavior<Dummy, int, int> b{};
+    b.persists();  // No return value.
+    DRTEST_ASSERT(not b.is_stub());
+  }
+
+  {
+    Behavior<Dummy, void, int> b{};
+    b.persists();
+    DRTEST_ASSERT(b.is_stub());
+    b.throws(std::runtime_error{""});
+    DRTEST_ASSERT(not b.is_stub());
+  }
+}
+
+DRTEST_TEST(expectsStatic)
+{
+  Behavior<Dummy, void, std::string, float, int> b{};
+  b.expects_static(eq("foo"), almost(1.0), any());
+  DRTEST_ASSERT(b.match("foo", 0.999999f, 1));
+  DRTEST_ASSERT(b.match("foo", 1.0f, 2));
+  DRTEST_ASSERT(not b.match("bar", 1.0f, 1));
+  DRTEST_ASSERT(not b.match("foo", 0.9999f, 1));
+  DRTEST_ASSERT(not b.hash());
+
+  // Copies copy the matchers.
+  auto c = b;
+  DRTEST_ASSERT(c.match("foo", 1.0f, 2));
+
+  DRTEST_ASSERT_THROW(b.expects("foo", 1.0f, 1), std::runtime_error);
+  DRTEST_ASSERT_THROW(b.expects_static(eq("foo"), any(), any()), std::runtime_error);
+
+  Behavior<Dummy, void, std::string, float, int> d{};
+  d.expects("foo", 1.0f, 1);
+  DRTEST_ASSERT_THROW(d.expects_static(eq("foo"), any(), any()), std::runtime_error);
+}
+
+DRTEST_TEST(expectsStaticHash)
+{
+  Behavior<Dummy, void, int, std::string> b{};
+  b.expects_static(eq(1), eq("foo"));
+  DRTEST_ASSERT(b.hash());
+  DRTEST_ASSERT_EQ(*b.hash(), detail::hashAll(1, std::string{"foo"}));
+
+  Behavior<Dummy, void, int, std::string> c{};
+  c.expects_static(eq(1), any());
+  DRTEST_ASSERT(not c.hash());
+}
+
+DRTEST_TEST(expectsStaticLarge)
+{
+  // Matchers which don't fit into the buffer of `StaticMatch`.
+  using S = std::string;
+  std::optional<Behavior<Dummy, void, S, S, S, S>> b{std::in_place};
+  b->expects_static(eq("a"), eq("b"), eq("c"), eq("d"));
+  auto c = *b;
+  b.reset();
+  DRTEST_ASSERT(c.match("a", "b", "c", "d"));
+  DRTEST_ASSERT(not c.match("a", "b", "c", "e"));
+}
+
+DRTEST_TEST(expectsStaticPointer)
+{
+  // `eq` compares pointers by their pointees, like `Equal`.
+  Behavior<Dummy, void, std::shared_ptr<Base>> b{};
+  b.expects_static(eq(std::make_shared<Base>(1)));
+  DRTEST_ASSERT(b.match(std::make_shared<Base>(1)));
+  DRTEST_ASSERT(not b.match(std::make_shared<Base>(2)));
+}
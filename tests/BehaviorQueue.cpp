@@ -16,10 +16,14 @@
  * along with DrMock.  If not, see <https://www.gnu.org/licenses/>.
 */
 
+#include <array>
 #include <string>
 #include <memory>
+#include <thread>
+#include <vector>
 
 #include <DrMock/Test.h>
+#include <DrMock/mock/AlmostEqual.h>
 #include <DrMock/mock/BehaviorQueue.h>
 
 using namespace drmock;
@@ -30,10 +34,7 @@ public:
   void f(int, float, double) {}
 };
 
-using Result = std::pair<
-    std::shared_ptr<int>,
-    std::shared_ptr<AbstractSignal<Dummy>>
-  >;
+using Result = std::pair<int*, AbstractSignal<Dummy>*>;
 
 DRTEST_TEST(isExhausted)
 {
@@ -55,6 +56,54 @@ DRTEST_TEST(isExhausted)
   DRTEST_ASSERT(m.is_exhausted());
 }
 
+DRTEST_TEST(clear)
+{
+  auto arena = std::make_shared<detail::Arena>();
+  auto make_tuple_of_matchers = std::make_shared<detail::MakeTupleOfMatchers<std::tuple<int>>>(arena);
+  BehaviorQueue<Dummy, int, int> m{make_tuple_of_matchers, arena};
+  m.enforce_order(false);
+  for (int i = 0; i < 1000; ++i)
+  {
+    m.push().expects(i).returns(i);
+  }
+  m.call(3);
+  DRTEST_ASSERT(not m.is_exhausted());
+
+  // The old arena is only kept alive by the caller.
+  std::weak_ptr<detail::Arena> old_arena = arena;
+  auto new_arena = std::make_shared<detail::Arena>();
+  m.clear(make_tuple_of_matchers->rebind(new_arena), new_arena);
+  make_tuple_of_matchers.reset();
+  arena.reset();
+  DRTEST_ASSERT(old_arena.expired());
+  DRTEST_ASSERT(m.is_exhausted());
+  DRTEST_ASSERT(std::holds_alternative<std::monostate>(m.call(3)));
+
+  // The order is still not enforced.
+  m.push().expects(1).returns(1);
+  m.push().expects(2).returns(2);
+  DRTEST_ASSERT(not m.is_exhausted());
+  DRTEST_ASSERT(not std::holds_alternative<std::monostate>(m.call(2)));
+  DRTEST_ASSERT(not std::holds_alternative<std::monostate>(m.call(1)));
+  DRTEST_ASSERT(m.is_exhausted());
+  DRTEST_ASSERT(new_arena->capacity() > 0);
+}
+
+DRTEST_TEST(stub)
+{
+  auto arena = std::make_shared<detail::Arena>();
+  auto make_tuple_of_matchers = std::make_shared<detail::MakeTupleOfMatchers<std::tuple<int>>>(arena);
+  BehaviorQueue<Dummy, int, int> m{make_tuple_of_matchers, arena};
+  DRTEST_ASSERT(not m.stub());
+  m.push().expects(1).returns(1);
+  auto& stub = m.push().returns(2).persists();
+  DRTEST_ASSERT(not m.stub());
+
+  // Once the behaviors before it are exhausted, the stub is found.
+  m.call(1);
+  DRTEST_ASSERT_EQ(m.stub(), &stub);
+}
+
 DRTEST_TEST(enforceOrderFail)
 {
   BehaviorQueue<Dummy, void, int, std::string> m{};
@@ -83,6 +132,141 @@ DRTEST_TEST(noEnforceOrder)
   DRTEST_ASSERT(std::holds_alternative<std::monostate>(result));
 }
 
+DRTEST_TEST(noEnforceOrderExhausted)
+{
+  // Behaviors that no longer persist aren't matched again, even if
+  // they're behind the front of the queue.
+  BehaviorQueue<Dummy, void, int, std::string> m{};
+  m.enforce_order(false);
+  m.push().expects(1, "foo").times(2);
+  m.push().expects(2, "foo").times(1);
+
+  auto result = m.call(2, "foo");
+  DRTEST_ASSERT(not std::holds_alternative<std::monostate>(result));
+  result = m.call(2, "foo");
+  DRTEST_ASSERT(std::holds_alternative<std::monostate>(result));
+  result = m.call(1, "foo");
+  DRTEST_ASSERT(not std::holds_alternative<std::monostate>(result));
+  DRTEST_ASSERT(not m.is_exhausted());
+  result = m.call(1, "foo");
+  DRTEST_ASSERT(not std::holds_alternative<std::monostate>(result));
+  DRTEST_ASSERT(m.is_exhausted());
+}
+
+DRTEST_TEST(manyBehaviors)
+{
+  // Dispatching through a long queue of one-shot behaviors must not
+  // rescan the exhausted behaviors at the front.
+  for (bool enforce_order : {true, false})
+  {
+    BehaviorQueue<Dummy, int, int> m{};
+    m.enforce_order(enforce_order);
+    for (int i = 0; i < 100000; ++i)
+    {
+      m.push().expects(i).returns(i);
+    }
+    for (int i = 0; i < 100000; ++i)
+    {
+      auto result = m.call(i);
+      DRTEST_ASSERT(std::holds_alternative<Result>(result));
+      DRTEST_ASSERT_EQ(*std::get<Result>(result).first, i);
+    }
+    DRTEST_ASSERT(m.is_exhausted());
+    DRTEST_ASSERT(std::holds_alternative<std::monostate>(m.call(0)));
+  }
+
+  // Unordered behaviors with hashable input are looked up by their
+  // input, not scanned.
+  BehaviorQueue<Dummy, int, int, std::string> m{};
+  m.enforce_order(false);
+  for (int i = 0; i < 100000; ++i)
+  {
+    m.push().expects(i, "foo").returns(i);
+  }
+  for (int i = 99999; i >= 0; --i)
+  {
+    auto result = m.call(i, "foo");
+    DRTEST_ASSERT(std::holds_alternative<Result>(result));
+    DRTEST_ASSERT_EQ(*std::get<Result>(result).first, i);
+  }
+  DRTEST_ASSERT(m.is_exhausted());
+}
+
+DRTEST_TEST(concurrent)
+{
+  // The first behavior produces exactly 2000 times, even if the calls
+  // race for the last productions.
+  constexpr int num_threads = 4;
+  constexpr int num_calls = 1000;
+  for (bool enforce_order : {true, false})
+  {
+    BehaviorQueue<Dummy, int, int> m{};
+    m.enforce_order(enforce_order);
+    m.concurrent(true);
+    m.push().expects(1).times(2000).returns(1);
+    m.push().expects(1).persists().returns(2);
+
+    std::vector<std::array<int, 3>> counts(num_threads);  // Zero-initialized
+    std::vector<std::thread> threads{};
+    for (int t = 0; t < num_threads; ++t)
+    {
+      threads.emplace_back([&m, &counts, t] () {
+          for (int i = 0; i < num_calls; ++i)
+          {
+            auto result = m.call(1);
+            ++counts[t][*std::get<Result>(result).first];
+          }
+          if (std::holds_alternative<std::monostate>(m.call(2)))
+          {
+            ++counts[t][0];  // Unmatched calls.
+          }
+        });
+    }
+    for (auto& thread : threads)
+    {
+      thread.join();
+    }
+
+    int unmatched = 0;
+    int ones = 0;
+    int twos = 0;
+    for (const auto& v : counts)
+    {
+      unmatched += v[0];
+      ones += v[1];
+      twos += v[2];
+    }
+    DRTEST_ASSERT_EQ(unmatched, num_threads);
+    DRTEST_ASSERT_EQ(ones, 2000);
+    DRTEST_ASSERT_EQ(twos, num_threads*num_calls - 2000);
+    DRTEST_ASSERT(m.is_exhausted());
+  }
+}
+
+DRTEST_TEST(noEnforceOrderFifo)
+{
+  // Of several behaviors matching the same input, the first is used
+  // until it's exhausted, no matter if matched by equality or not.
+  BehaviorQueue<Dummy, int, int, float> m{};
+  m.enforce_order(false);
+  m.push().expects(1, 2.0f).returns(1);
+  m.push().expects(1, almost_equal(2.0f)).returns(2);
+  m.push().expects(1, 2.0f).returns(3).times(2);
+  m.push().expects(2, 2.0f).returns(4);
+
+  for (int expected : {1, 2, 3, 3})
+  {
+    auto result = m.call(1, 2.0f);
+    DRTEST_ASSERT(std::holds_alternative<Result>(result));
+    DRTEST_ASSERT_EQ(*std::get<Result>(result).first, expected);
+  }
+  DRTEST_ASSERT(std::holds_alternative<std::monostate>(m.call(1, 2.0f)));
+  DRTEST_ASSERT(not m.is_exhausted());
+  auto result = m.call(2, 2.0f);
+  DRTEST_ASSERT_EQ(*std::get<Result>(result).first, 4);
+  DRTEST_ASSERT(m.is_exhausted());
+}
+
 DRTEST_TEST(enforceOrderSuccess)
 {
   BehaviorQueue<Dummy, void, int, std::string> m{};
@@ -118,7 +302,7 @@ DRTEST_TEST(nonVoid)
       .expects(4, "4");
 
   auto result = m.call(1, "1");
-  std::shared_ptr<int> sp = std::get<Result>(result).first;
+  int* sp = std::get<Result>(result).first;
   auto signal = std::get<Result>(result).second;
   DRTEST_COMPARE(*sp, 11);
   DRTEST_ASSERT(not signal);
@@ -154,12 +338,12 @@ DRTEST_TEST(nonCopyable)
       .returns(std::make_unique<int>(2));
 
   auto result = m.call(1, std::make_unique<int>(2));
-  auto sp = std::get<std::pair<std::shared_ptr<std::unique_ptr<int>>, std::shared_ptr<AbstractSignal<Dummy>>>>(result).first;
+  auto sp = std::get<std::pair<std::unique_ptr<int>*, AbstractSignal<Dummy>*>>(result).first;
   auto p = std::move(*sp);
   DRTEST_COMPARE(*p, 1);
 
   result = m.call(2, std::make_unique<int>(3));
-  sp = std::get<std::pair<std::shared_ptr<std::unique_ptr<int>>, std::shared_ptr<AbstractSignal<Dummy>>>>(result).first;
+  sp = std::get<std::pair<std::unique_ptr<int>*, AbstractSignal<Dummy>*>>(result).first;
   p = std::move(*sp);
   DRTEST_COMPARE(*p, 2);
 }
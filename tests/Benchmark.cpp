@@ -0,0 +1,98 @@
+/* Copyright 2021 Ole Kliemann, Malte Kliemann
+ *
+ * This file is part of DrMock.
+ *
+ * DrMock is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DrMock is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DrMock.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <sstream>
+#include <vector>
+
+#include <DrMock/Test.h>
+
+using namespace drtest::detail;
+
+DRTEST_DATA(statistics)
+{
+  drtest::addColumns<std::vector<double>, double, double, double, double>(
+      "samples", "median", "mad", "min", "p90"
+    );
+  drtest::addRow("single", std::vector<double>{3.0}, 3.0, 0.0, 3.0, 3.0);
+  drtest::addRow("odd", std::vector<double>{5.0, 1.0, 3.0}, 3.0, 2.0, 1.0, 4.6);
+  drtest::addRow("even", std::vector<double>{4.0, 1.0, 2.0, 3.0}, 2.5, 1.0, 1.0, 3.7);
+  drtest::addRow(
+      "outlier",
+      std::vector<double>{10.0, 10.0, 11.0, 9.0, 1000.0},
+      10.0, 1.0, 9.0, 604.4
+    );
+}
+
+DRTEST_TEST(statistics)
+{
+  DRTEST_FETCH_REF(std::vector<double>, samples);
+  DRTEST_FETCH(double, median);
+  DRTEST_FETCH(double, mad);
+  DRTEST_FETCH(double, min);
+  DRTEST_FETCH(double, p90);
+  auto stats = computeStatistics(samples);
+  DRTEST_ASSERT_EQ(stats.samples, samples.size());
+  DRTEST_ASSERT_ALMOST_EQUAL(stats.median, median);
+  DRTEST_ASSERT_ALMOST_EQUAL(stats.mad, mad);
+  DRTEST_ASSERT_ALMOST_EQUAL(stats.min, min);
+  DRTEST_ASSERT_ALMOST_EQUAL(stats.p90, p90);
+}
+
+DRTEST_TEST(run)
+{
+  std::size_t calls = 0;
+  Benchmark benchmark{3, std::chrono::microseconds{100}, std::chrono::microseconds{0}};
+  auto result = benchmark.run([&calls] () { drtest::doNotOptimize(++calls); });
+  DRTEST_ASSERT_EQ(result.statistics.samples, 3u);
+  DRTEST_ASSERT(calls >= 3*result.iterations);
+  DRTEST_ASSERT(result.statistics.min <= result.statistics.median);
+  DRTEST_ASSERT(result.statistics.median <= result.statistics.max);
+}
+
+DRTEST_TEST(json)
+{
+  BenchmarkResult result{"a\"b", "row\n", 10, {}};
+  result.statistics.median = 1.5;
+  std::stringstream s{};
+  writeBenchmarkJson(s, {result});
+  std::string json = s.str();
+  DRTEST_ASSERT(json.find("\"test\": \"a\\\"b\"") != std::string::npos);
+  DRTEST_ASSERT(json.find("\"row\": \"row\\n\"") != std::string::npos);
+  DRTEST_ASSERT(json.find("\"median_ns\": 1.5") != std::string::npos);
+  DRTEST_ASSERT_EQ(escapeJson(std::string{"\x01"}), std::string{"\\u0001"});
+}
+
+DRTEST_DATA(vectorPushBack)
+{
+  drtest::addColumn<std::size_t>("size");
+  drtest::addRow("10", std::size_t{10});
+  drtest::addRow("100", std::size_t{100});
+}
+
+DRTEST_BENCHMARK(vectorPushBack)
+{
+  DRTEST_FETCH(std::size_t, size);
+  drtest::measure([size] () {
+      std::vector<std::size_t> v{};
+      for (std::size_t i = 0; i < size; ++i)
+      {
+        v.push_back(i);
+      }
+      drtest::doNotOptimize(v.data());
+    });
+}
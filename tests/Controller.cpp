@@ -19,6 +19,7 @@
 #include <DrMock/Test.h>
 #include <DrMock/mock/Controller.h>
 #include <DrMock/mock/IMethod.h>
+#include <DrMock/mock/Method.h>
 
 using namespace drmock;
 using namespace drtest;
@@ -95,3 +96,113 @@ DRTEST_TEST(makeFormattedErrorString)
   auto err = collection.makeFormattedErrorString();
   DRTEST_ASSERT_EQ(err, "foo\nbar");
 }
+
+DRTEST_TEST(calls)
+{
+  class Dummy {};
+  auto f = std::make_shared<Method<Dummy, void, int>>("f");
+  auto g = std::make_shared<Method<Dummy, void, std::string>>("g");
+  f->record(4);
+  g->record(4);
+  Controller collection{{f, std::make_shared<MockMethod>(true), g}};
+  f->call(1);
+  g->call("foo");
+  f->call(2);
+  g->call("bar");
+
+  auto calls = collection.calls();
+  DRTEST_ASSERT_EQ(calls.size(), std::size_t{4});
+  std::vector<std::string> methods{};
+  for (const auto& call : calls)
+  {
+    methods.push_back(call.method);
+  }
+  DRTEST_ASSERT_EQ(methods, (std::vector<std::string>{"f", "g", "f", "g"}));
+
+  auto g_calls = collection.calls("g");
+  DRTEST_ASSERT_EQ(g_calls.size(), std::size_t{2});
+  DRTEST_ASSERT_EQ(g_calls[0].sequence, calls[1].sequence);
+  DRTEST_ASSERT_EQ(g_calls[1].sequence, calls[3].sequence);
+}
+
+DRTEST_TEST(trackedVerify)
+{
+  class Dummy {};
+  auto f = std::make_shared<Method<Dummy, void, int>>("f");
+  auto g = std::make_shared<Method<Dummy, void, int>>("g");
+  f->push().expects(1).times(2);
+  Controller collection{{f, g, std::make_shared<MockMethod>(true)}};
+  DRTEST_ASSERT(not collection.verify());
+  f->call(1);
+  DRTEST_ASSERT(not collection.verify());
+  f->call(1);
+  DRTEST_ASSERT(collection.verify());
+  DRTEST_ASSERT_EQ(collection.makeFormattedErrorString(), "");
+
+  // Behaviors pushed after the construction of the controller.
+  g->push().expects(2).persists();
+  g->push().expects(3);
+  DRTEST_ASSERT(not collection.verify());
+  g->io().back().times(0, 1);
+  DRTEST_ASSERT(collection.verify());
+
+  // A failed call.
+  g->call(1);
+  DRTEST_ASSERT(not collection.verify());
+  auto err = collection.makeFormattedErrorString();
+  DRTEST_ASSERT(err.find("\"g\"") != std::string::npos);
+  DRTEST_ASSERT(err.find("\"f\"") == std::string::npos);
+
+  // The queue of a method with state behavior is not verified.
+  auto h = std::make_shared<Method<Dummy, void, int>>("h");
+  h->push().expects(1);
+  Controller other{{h}};
+  DRTEST_ASSERT(not other.verify());
+  h->state();
+  DRTEST_ASSERT(other.verify());
+}
+
+DRTEST_TEST(clearQueues)
+{
+  class Dummy {};
+  auto state_object = std::make_shared<StateObject>();
+  auto f = std::make_shared<Method<Dummy, void, int>>("f", state_object);
+  auto g = std::make_shared<Method<Dummy, void, int>>("g", state_object);
+  Controller collection{{f, g, std::make_shared<MockMethod>(true)}, state_object};
+  for (int i = 0; i < 100; ++i)
+  {
+    f->push().expects(i);
+    g->push().expects(i);
+  }
+  DRTEST_ASSERT(not collection.verify());
+
+  // Once all queues are cleared, the arena of the mock is released.
+  std::weak_ptr<drmock::detail::Arena> old_arena = state_object->arena();
+  collection.clearQueues();
+  DRTEST_ASSERT(old_arena.expired());
+  DRTEST_ASSERT(collection.verify());
+
+  // All methods allocate from the new arena of the mock.
+  auto arena = state_object->arena();
+  auto capacity = arena->capacity();
+  for (int i = 0; i < 100; ++i)
+  {
+    f->push().expects(i);
+  }
+  DRTEST_ASSERT(arena->capacity() > capacity);
+  capacity = arena->capacity();
+  g->clearQueue();
+  for (int i = 0; i < 100; ++i)
+  {
+    g->push().expects(i);
+  }
+  DRTEST_ASSERT(arena->capacity() > capacity);
+  DRTEST_ASSERT(state_object->arena() == arena);
+  collection.clearQueues();
+
+  f->push().expects(1);
+  DRTEST_ASSERT(not collection.verify());
+  f->call(1);
+  DRTEST_ASSERT(collection.verify());
+}
+
@@ -0,0 +1,460 @@
+/* Copyright 2021 Ole Kliemann, Malte Kliemann
+ *
+ * This file is part of DrMock.
+ *
+ * DrMock is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DrMock is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DrMock.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <DrMock/Test.h>
+
+using namespace drtest::detail;
+
+class RecordingLogger final : public drutility::ILogger
+{
+public:
+  void logMessage(
+      bool,
+      const std::string& category,
+      const std::string& location,
+      int,
+      const std::ostream&
+    ) override
+  {
+    if (category.empty())
+    {
+      return;
+    }
+    std::lock_guard lck{mtx_};
+    messages_.push_back(category + " " + location);
+  }
+
+  std::vector<std::string> messages() const
+  {
+    return messages_;
+  }
+
+private:
+  std::mutex mtx_{};
+  std::vector<std::string> messages_{};
+};
+
+// Run `global` with `logger` installed as logger singleton.
+void runWithLogger(Global& global, std::shared_ptr<drutility::ILogger> logger)
+{
+  auto previous = drutility::Singleton<drutility::ILogger>::get();
+  drutility::Singleton<drutility::ILogger>::set(logger);
+  global.runTestsAndLog();
+  drutility::Singleton<drutility::ILogger>::set(previous);
+}
+
+DRTEST_TEST(parallelRun)
+{
+  Global global{};
+  std::atomic<int> num_init{0};
+  std::atomic<int> num_cleanup{0};
+  std::atomic<int> num_running{0};
+  std::atomic<int> max_running{0};
+  std::atomic<bool> init_test_case_done{false};
+  std::atomic<bool> init_test_case_first{true};
+  global.addTestFunc("initTestCase", [&] () {
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+      init_test_case_done = true;
+    });
+  global.addTestFunc("init", [&] () { ++num_init; });
+  global.addTestFunc("cleanup", [&] () { ++num_cleanup; });
+  global.addTestFunc("cleanupTestCase", [&] () {
+      if (num_running != 0)
+      {
+        throw TestFailure{__LINE__, "cleanupTestCase before end of tests"};
+      }
+    });
+
+  std::vector<std::string> names{"a", "b", "c", "d", "e", "f", "g", "h"};
+  for (std::size_t i = 0; i < names.size(); ++i)
+  {
+    // Let early tests finish last.
+    global.addTestFunc(names[i], [&, i] () {
+        if (not init_test_case_done)
+        {
+          init_test_case_first = false;
+        }
+        int running = ++num_running;
+        int expected = max_running;
+        while (running > expected and not max_running.compare_exchange_weak(expected, running))
+        {}
+        std::this_thread::sleep_for(std::chrono::milliseconds(5*(names.size() - i)));
+        --num_running;
+      });
+  }
+  global.addDataFunc("rows", [&] () {
+      global.addColumn<int>("value");
+      global.addRow("row 1", 1);
+      global.addRow("row 2", 2);
+    });
+  global.addTestFunc("rows", [&] () {
+      if (global.fetchData<int>("value") == 2)
+      {
+        throw TestFailure{__LINE__, "expected failure"};
+      }
+    });
+
+  Options options{};
+  options.jobs = 4;
+  global.configure(options);
+  auto logger = std::make_shared<RecordingLogger>();
+  runWithLogger(global, logger);
+
+  DRTEST_ASSERT_EQ(global.num_failures(), 1u);
+  DRTEST_ASSERT_EQ(num_init.load(), 9);
+  DRTEST_ASSERT_EQ(num_cleanup.load(), 9);
+  DRTEST_ASSERT(init_test_case_first.load());
+  DRTEST_ASSERT(max_running.load() > 1);
+
+  // The log is in order of registration.
+  std::vector<std::string> expected{};
+  for (const auto& name : names)
+  {
+    expected.push_back("TEST " + name);
+    expected.push_back("PASS " + name);
+  }
+  expected.push_back("TEST rows, row 1");
+  expected.push_back("PASS rows, row 1");
+  expected.push_back("TEST rows, row 2");
+  expected.push_back("*FAIL rows, row 2");
+  DRTEST_ASSERT(logger->messages() == expected);
+}
+
+DRTEST_TEST(parallelBenchmarks)
+{
+  Global global{};
+  std::atomic<int> num_running{0};
+  std::atomic<int> max_running{0};
+  auto run = [&] () {
+    int running = ++num_running;
+    int expected = max_running;
+    while (running > expected and not max_running.compare_exchange_weak(expected, running))
+    {}
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    --num_running;
+  };
+  for (const auto& name : {"d", "c", "b", "a"})
+  {
+    global.addTestFunc(std::string{"test "} + name, run);
+  }
+  // Register in reverse order of the names.
+  for (const auto& name : {"bench 2", "bench 1"})
+  {
+    global.addBenchmarkFunc(name, [&] () {
+        if (++num_running != 1)
+        {
+          throw TestFailure{__LINE__, "benchmark runs concurrently"};
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        if (num_running-- != 1)
+        {
+          throw TestFailure{__LINE__, "benchmark runs concurrently"};
+        }
+        global.addBenchmarkResult({{}, {}, 1, {}});
+      });
+  }
+
+  std::string path = "Global_parallelBenchmarks.json";
+  Options options{};
+  options.jobs = 4;
+  options.benchmark_json = path;
+  global.configure(options);
+  runWithLogger(global, std::make_shared<RecordingLogger>());
+  DRTEST_ASSERT_EQ(global.num_failures(), 0u);
+
+  // The tests run concurrently, the benchmarks don't.
+  DRTEST_ASSERT(max_running.load() > 1);
+  std::ifstream f{path};
+  std::string json{std::istreambuf_iterator<char>{f}, std::istreambuf_iterator<char>{}};
+  f.close();
+  std::remove(path.c_str());
+  auto first = json.find("bench 1");
+  DRTEST_ASSERT(first != std::string::npos);
+  DRTEST_ASSERT(first < json.find("bench 2"));
+}
+
+DRTEST_TEST(abortOnInitFailure)
+{
+  Global global{};
+  std::atomic<bool> cleanup_test_case{false};
+  global.addTestFunc("init", [] () { throw TestFailure{__LINE__, "init failed"}; });
+  global.addTestFunc("cleanupTestCase", [&] () { cleanup_test_case = true; });
+  global.addTestFunc("a", [] () {});
+  global.addTestFunc("b", [] () {});
+
+  Options options{};
+  options.jobs = 2;
+  global.configure(options);
+  runWithLogger(global, std::make_shared<RecordingLogger>());
+
+  DRTEST_ASSERT(global.num_failures() > 0);
+  DRTEST_ASSERT(not cleanup_test_case);
+}
+
+DRTEST_DATA(options)
+{
+  drtest::addColumns<std::vector<std::string>, std::size_t>("args", "jobs");
+  drtest::addRow("default", std::vector<std::string>{}, std::size_t{1});
+  drtest::addRow("separate", std::vector<std::string>{"--jobs", "4"}, std::size_t{4});
+  drtest::addRow("equals", std::vector<std::string>{"--jobs=8"}, std::size_t{8});
+  drtest::addRow("unknown", std::vector<std::string>{"-platform", "offscreen"}, std::size_t{1});
+}
+
+DRTEST_TEST(options)
+{
+  DRTEST_FETCH(std::vector<std::string>, args);
+  DRTEST_FETCH(std::size_t, jobs);
+  std::vector<char*> argv{const_cast<char*>("test")};
+  for (auto& arg : args)
+  {
+    argv.push_back(arg.data());
+  }
+  auto options = parseOptions(static_cast<int>(argv.size()), argv.data());
+  DRTEST_ASSERT_EQ(options.jobs, jobs);
+}
+
+DRTEST_TEST(optionsInvalid)
+{
+  std::vector<std::string> args{"test", "--jobs", "x"};
+  std::vector<char*> argv{};
+  for (auto& arg : args)
+  {
+    argv.push_back(arg.data());
+  }
+  DRTEST_ASSERT_THROW(parseOptions(3, argv.data()), std::invalid_argument);
+  DRTEST_ASSERT_THROW(parseOptions(2, argv.data()), std::invalid_argument);
+}
+
+DRTEST_TEST(shards)
+{
+  std::vector<std::string> all{};
+  std::size_t total_failures = 0;
+  for (std::size_t index = 0; index < 3; ++index)
+  {
+    Global global{};
+    for (int i = 0; i < 10; ++i)
+    {
+      global.addTestFunc("test" + std::to_string(i), [] () {});
+    }
+    global.addDataFunc("rows", [&global] () {
+        global.addColumn<int>("x");
+        for (int i = 0; i < 10; ++i)
+        {
+          global.addRow("row " + std::to_string(i), i);
+        }
+      });
+    global.addTestFunc("rows", [&global] () {
+        if (global.fetchData<int>("x") == 7)
+        {
+          throw TestFailure{__LINE__, "row 7"};
+        }
+      });
+
+    Options options{};
+    options.shard_index = index;
+    options.shard_count = 3;
+    global.configure(options);
+    auto logger = std::make_shared<RecordingLogger>();
+    runWithLogger(global, logger);
+    total_failures += global.num_failures();
+    for (const auto& msg : logger->messages())
+    {
+      if (msg.rfind("TEST ", 0) == 0)
+      {
+        all.push_back(msg);
+      }
+    }
+  }
+
+  // Every test and row runs on exactly one shard.
+  DRTEST_ASSERT_EQ(all.size(), 20u);
+  std::sort(all.begin(), all.end());
+  DRTEST_ASSERT(std::adjacent_find(all.begin(), all.end()) == all.end());
+  DRTEST_ASSERT_EQ(total_failures, 1u);
+}
+
+DRTEST_TEST(shardOptions)
+{
+  std::vector<std::string> args{"test", "--shard-index=1", "--shard-count", "4", "--merge-summary=a", "--merge-summary", "b"};
+  std::vector<char*> argv{};
+  for (auto& arg : args)
+  {
+    argv.push_back(arg.data());
+  }
+  auto options = parseOptions(static_cast<int>(argv.size()), argv.data());
+  DRTEST_ASSERT_EQ(options.shard_index, 1u);
+  DRTEST_ASSERT_EQ(options.shard_count, 4u);
+  DRTEST_ASSERT(options.merge_summaries == (std::vector<std::string>{"a", "b"}));
+
+  // The index must be smaller than the count.
+  DRTEST_ASSERT_THROW(parseOptions(3, argv.data()), std::invalid_argument);
+}
+
+DRTEST_TEST(summaries)
+{
+  DRTEST_ASSERT_EQ(mergeSummaries({{0, 2, 3}, {1, 2, 4}}), 7u);
+  DRTEST_ASSERT_THROW(mergeSummaries({}), std::runtime_error);
+  DRTEST_ASSERT_THROW(mergeSummaries({{0, 2, 0}}), std::runtime_error);
+  DRTEST_ASSERT_THROW(mergeSummaries({{0, 2, 0}, {0, 2, 0}}), std::runtime_error);
+  DRTEST_ASSERT_THROW(mergeSummaries({{0, 2, 0}, {1, 3, 0}}), std::runtime_error);
+
+  std::string path = "Global_summary.txt";
+  writeSummary(path, {1, 3, 5});
+  auto summary = readSummary(path);
+  std::remove(path.c_str());
+  DRTEST_ASSERT_EQ(summary.index, 1u);
+  DRTEST_ASSERT_EQ(summary.count, 3u);
+  DRTEST_ASSERT_EQ(summary.failures, 5u);
+  DRTEST_ASSERT_THROW(readSummary(path), std::runtime_error);
+}
+
+DRTEST_DATA(parallelRows)
+{
+  drtest::addColumns<std::size_t>("jobs");
+  drtest::addRow("serial", std::size_t{1});
+  drtest::addRow("two", std::size_t{2});
+  drtest::addRow("parallel", std::size_t{4});
+}
+
+DRTEST_TEST(parallelRows)
+{
+  DRTEST_FETCH(std::size_t, jobs);
+
+  Global global{};
+  std::atomic<int> sum{0};
+  std::atomic<std::size_t> num_running{0};
+  std::atomic<std::size_t> max_running{0};
+  global.addDataFunc("rows", [&global] () {
+      global.addColumn<int>("x");
+      for (int i = 0; i < 20; ++i)
+      {
+        global.addRow("row " + std::to_string(i), i, drtest::tags::parallel);
+      }
+      global.addRow("row 20", 20);
+      global.tagRow("row 3", drtest::tags::xfail);
+    });
+  global.addTestFunc("rows", [&] () {
+      // Rows and tests together must not use more threads than `jobs`.
+      std::size_t running = ++num_running;
+      for (std::size_t max = max_running; max < running
+          and not max_running.compare_exchange_weak(max, running); )
+      {}
+      std::this_thread::sleep_for(std::chrono::milliseconds(2));
+      --num_running;
+
+      int x = global.fetchData<int>("x");
+      sum += x;
+      if (x % 3 == 0)
+      {
+        throw TestFailure{__LINE__, "x divisible by 3"};
+      }
+    });
+  global.addTestFunc("after", [] () {});
+
+  Options options{};
+  options.jobs = jobs;
+  global.configure(options);
+  auto logger = std::make_shared<RecordingLogger>();
+  runWithLogger(global, logger);
+
+  // Rows 0, 6, 9, 12, 15 and 18 fail, row 3 is xfailed.
+  DRTEST_ASSERT_EQ(global.num_failures(), 6u);
+  DRTEST_ASSERT_EQ(sum.load(), 210);
+  DRTEST_ASSERT_LE(max_running.load(), jobs);
+
+  // The log is in order of the rows.
+  auto messages = logger->messages();
+  DRTEST_ASSERT_EQ(messages.size(), 2*21u + 2u);
+  for (std::size_t i = 0; i <= 20; ++i)
+  {
+    DRTEST_ASSERT_EQ(messages[2*i], "TEST rows, row " + std::to_string(i));
+  }
+  DRTEST_ASSERT_EQ(messages.back(), std::string{"PASS after"});
+}
+
+DRTEST_TEST(parallelRowsState)
+{
+  Global global{};
+  global.addDataFunc("rows", [&global] () {
+      global.addColumn<int>("x");
+      for (int i = 0; i < 16; ++i)
+      {
+        global.addRow("row " + std::to_string(i), i, drtest::tags::parallel);
+      }
+    });
+  global.addTestFunc("rows", [&global] () {
+      // Only the even rows are xfailed; `xfail` must not leak into the
+      // odd rows running concurrently.
+      int x = global.fetchData<int>("x");
+      if (x % 2 == 0)
+      {
+        global.xfail();
+      }
+      throw TestFailure{__LINE__, "fail"};
+    });
+
+  Options options{};
+  options.jobs = 4;
+  global.configure(options);
+  runWithLogger(global, std::make_shared<RecordingLogger>());
+  DRTEST_ASSERT_EQ(global.num_failures(), 8u);
+}
+
+DRTEST_TEST(report)
+{
+  Global global{};
+  global.addTestFunc("pass", [] () { std::this_thread::sleep_for(std::chrono::milliseconds{10}); });
+  global.addTestFunc("fail", [] () { throw TestFailure{__LINE__, "fail"}; });
+  global.addTestFunc("skip", [] () { drtest::skip(); });
+
+  std::string path = "Global_report.json";
+  Options options{};
+  options.name = "name";
+  options.report = path;
+  global.configure(options);
+  runWithLogger(global, std::make_shared<RecordingLogger>());
+
+  std::ifstream f{path};
+  std::string json{std::istreambuf_iterator<char>{f}, std::istreambuf_iterator<char>{}};
+  f.close();
+  std::remove(path.c_str());
+  DRTEST_ASSERT(json.find("\"name\": \"name\"") != std::string::npos);
+  DRTEST_ASSERT(json.find("{\"test\": \"init\", \"row\": \"\", \"context\": \"pass\", \"status\": \"pass\"") != std::string::npos);
+  DRTEST_ASSERT(json.find("{\"test\": \"fail\", \"row\": \"\", \"status\": \"fail\"") != std::string::npos);
+  DRTEST_ASSERT(json.find("{\"test\": \"skip\", \"row\": \"\", \"status\": \"skip\"") != std::string::npos);
+  DRTEST_ASSERT(json.find("{\"test\": \"cleanupTestCase\"") != std::string::npos);
+
+  // The sleeping test takes at least 10ms of wall, but hardly any CPU
+  // time.
+  auto pos = json.find("{\"test\": \"pass\"");
+  DRTEST_ASSERT(pos != std::string::npos);
+  auto wall = std::stod(json.substr(json.find("\"wall_time\": ", pos) + 13));
+  auto cpu = std::stod(json.substr(json.find("\"cpu_time\": ", pos) + 12));
+  DRTEST_ASSERT(wall >= 0.01);
+  DRTEST_ASSERT(cpu < wall);
+}
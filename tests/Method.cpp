@@ -16,14 +16,48 @@
  * along with DrMock.  If not, see <https://www.gnu.org/licenses/>.
 */
 
+#include <functional>
+#include <ostream>
 #include <string>
+#include <string_view>
 #include <memory>
+#include <thread>
+#include <vector>
 
 #include <DrMock/Test.h>
 #include <DrMock/mock/Method.h>
 
 class Dummy {};
 
+// Hashable by equality, but all objects have the same hash.
+struct Colliding
+{
+  int x;
+};
+
+bool operator==(const Colliding& lhs, const Colliding& rhs)
+{
+  return lhs.x == rhs.x;
+}
+
+std::ostream& operator<<(std::ostream& os, const Colliding& c)
+{
+  return os << "Colliding{" << c.x << "}";
+}
+
+namespace std {
+
+template<>
+struct hash<Colliding>
+{
+  std::size_t operator()(const Colliding&) const
+  {
+    return 0;
+  }
+};
+
+} // namespace std
+
 using namespace drmock;
 
 DRTEST_TEST(enforceOrderFail)
@@ -76,6 +110,42 @@ DRTEST_TEST(enforceOrderSuccess)
   DRTEST_ASSERT(m.verify());
 }
 
+DRTEST_TEST(clearQueue)
+{
+  auto state_object = std::make_shared<StateObject>();
+  Method<Dummy, int, int> m{"test", state_object};
+  for (int i = 0; i < 1000; ++i)
+  {
+    m.push().expects(i).returns(i);
+  }
+  DRTEST_ASSERT(not m.verify());
+
+  // The arena shared with the other methods of the mock is kept.
+  auto arena = state_object->arena();
+  m.clearQueue();
+  DRTEST_ASSERT(state_object->arena() == arena);
+  DRTEST_ASSERT(m.verify());
+
+  // Once moved to a new arena, the old one is released.
+  std::weak_ptr<detail::Arena> old_arena = arena;
+  arena.reset();
+  state_object->renewArena();
+  m.clearQueue(state_object->arena());
+  DRTEST_ASSERT(old_arena.expired());
+
+  m.push().expects(1).returns(2);
+  DRTEST_ASSERT(not m.verify());
+  auto result = m.call(1);
+  DRTEST_ASSERT(result);
+  DRTEST_ASSERT_EQ(*result, 2);
+  DRTEST_ASSERT(m.verify());
+
+  // Failed calls are not cleared.
+  m.call(1);
+  m.clearQueue();
+  DRTEST_ASSERT(not m.verify());
+}
+
 DRTEST_TEST(nonVoid)
 {
   Method<Dummy, int, int, std::string> m{"test"};
@@ -88,7 +158,7 @@ DRTEST_TEST(nonVoid)
       .returns(22);
 
   DRTEST_ASSERT(not m.verify());
-  std::shared_ptr<int> sp = m.call(1, "1");
+  int* sp = m.call(1, "1");
   DRTEST_ASSERT(not m.verify());
   DRTEST_COMPARE(*sp, 11);
 
@@ -98,6 +168,295 @@ DRTEST_TEST(nonVoid)
   DRTEST_ASSERT(m.verify());
 }
 
+DRTEST_TEST(returnsStoredValue)
+{
+  // Repeated calls return a pointer to the same stored value.
+  Method<Dummy, int, int> m{"test"};
+  m.push()
+      .expects(1)
+      .returns(11)
+      .persists();
+  int* p = m.call(1);
+  DRTEST_ASSERT(p);
+  DRTEST_COMPARE(*p, 11);
+  DRTEST_ASSERT_EQ(m.call(1), p);
+
+  Method<Dummy, int, int> n{"test"};
+  n.state().returns("", 22);
+  p = n.call(1);
+  DRTEST_ASSERT(p);
+  DRTEST_COMPARE(*p, 22);
+  DRTEST_ASSERT_EQ(n.call(2), p);
+}
+
+DRTEST_TEST(stub)
+{
+  Method<Dummy, int, int> m{"test"};
+  m.push()
+      .expects()
+      .returns(11)
+      .persists();
+  m.push()
+      .expects(1)
+      .returns(22);  // Unreachable.
+  int* p = m.call(1);
+  DRTEST_ASSERT(p);
+  DRTEST_COMPARE(*p, 11);
+  DRTEST_ASSERT_EQ(m.call(2), p);
+  DRTEST_ASSERT(not m.verify());
+
+  // The state behavior takes precedence over the stub.
+  m.state().returns("", 33);
+  DRTEST_COMPARE(*m.call(1), 33);
+  m.io();  // Reactivates the queue.
+  DRTEST_COMPARE(*m.call(1), 11);
+
+  // A stub that takes the place of an exhausted behavior is found.
+  m.clearQueue();
+  m.push()
+      .expects(1)
+      .returns(44);
+  auto& stub = m.push()
+      .expects()
+      .returns(55)
+      .persists();
+  DRTEST_COMPARE(*m.call(1), 44);
+  DRTEST_COMPARE(*m.call(2), 55);
+  // Reconfiguring the cached stub is not supported, but reveals that
+  // the fast path is taken: It doesn't match the arguments.
+  stub.expects(7);
+  DRTEST_COMPARE(*m.call(1), 55);
+}
+
+DRTEST_TEST(boundedFailedCalls)
+{
+  Method<Dummy, void, int> m{"test"};
+  m.capture_limit(2);
+  for (int i = 0; i < 100000; i++)
+  {
+    m.call(i % 3);
+  }
+  DRTEST_ASSERT(not m.verify());
+  DRTEST_ASSERT_EQ(m.num_failed_calls(), std::size_t{100000});
+
+  // Only the first two and the last two calls are captured in full.
+  auto msgs = m.error_msgs();
+  DRTEST_ASSERT_EQ(msgs.size(), std::size_t{4});
+  DRTEST_ASSERT_EQ(msgs[0].size(), std::size_t{1});
+  DRTEST_ASSERT_EQ(msgs[0].back().back(), '0');
+  DRTEST_ASSERT_EQ(msgs[1].back().back(), '1');
+  DRTEST_ASSERT_EQ(msgs[2].back().back(), '2');  // 99998 % 3
+  DRTEST_ASSERT_EQ(msgs[3].back().back(), '0');  // 99999 % 3
+
+  // The remaining calls are grouped; at most two groups are kept.
+  auto str = m.makeFormattedErrorString();
+  DRTEST_ASSERT(str.find("no behavior specified for 99996 more calls") != std::string::npos);
+  DRTEST_ASSERT(str.find("33332 calls with") != std::string::npos);
+  DRTEST_ASSERT(str.size() < 1000);
+}
+
+DRTEST_TEST(noCaptureLimit)
+{
+  Method<Dummy, void, std::unique_ptr<int>> m{"test"};
+  m.capture_limit(0);
+  m.call(std::make_unique<int>(1));
+  m.call(std::make_unique<int>(2));
+  DRTEST_ASSERT(not m.verify());
+  DRTEST_ASSERT_EQ(m.num_failed_calls(), std::size_t{2});
+  DRTEST_ASSERT(m.error_msgs().empty());
+  DRTEST_ASSERT(m.makeFormattedErrorString().find("2 more calls") != std::string::npos);
+}
+
+DRTEST_TEST(failedCallsCollidingHashes)
+{
+  Method<Dummy, void, Colliding> m{"test"};
+  m.capture_limit(2);
+  for (int i = 0; i < 10; i++)
+  {
+    m.call(Colliding{i % 2});
+  }
+
+  // Six omitted calls in two groups, although all hashes are equal.
+  auto str = m.makeFormattedErrorString();
+  DRTEST_ASSERT(str.find("no behavior specified for 6 more calls") != std::string::npos);
+  auto first = str.find("3 calls with");
+  DRTEST_ASSERT(first != std::string::npos);
+  DRTEST_ASSERT(str.find("3 calls with", first + 1) != std::string::npos);
+}
+
+struct HoldsView
+{
+  bool operator==(const HoldsView& other) const
+  {
+    return view == other.view;
+  }
+
+  std::string_view view;
+};
+
+std::ostream& operator<<(std::ostream& os, const HoldsView& x)
+{
+  return os << x.view;
+}
+
+DRTEST_TEST(failedCallsNonOwning)
+{
+  // Views are rendered before their referent is destroyed.
+  Method<Dummy, void, std::string_view> m{"test"};
+  {
+    std::string s{"some argument"};
+    m.call(s);
+  }
+  DRTEST_ASSERT(m.makeFormattedErrorString().find("some argument") != std::string::npos);
+
+  // So are other types which may hold views.
+  Method<Dummy, void, HoldsView> v{"test"};
+  {
+    std::string s{"nested argument"};
+    v.call(HoldsView{s});
+  }
+  auto msgs = v.error_msgs();
+  DRTEST_ASSERT_EQ(msgs.size(), std::size_t{1});
+  DRTEST_ASSERT_EQ(msgs, v.error_msgs());
+  DRTEST_ASSERT(msgs[0][0].find("nested argument") != std::string::npos);
+
+  // Shared pointers are not kept alive.
+  Method<Dummy, void, std::shared_ptr<int>> n{"test"};
+  std::weak_ptr<int> w{};
+  {
+    auto p = std::make_shared<int>(1);
+    w = p;
+    n.call(p);
+  }
+  DRTEST_ASSERT(w.expired());
+  DRTEST_ASSERT_EQ(n.error_msgs().size(), std::size_t{1});
+}
+
+DRTEST_TEST(concurrent)
+{
+  constexpr int num_threads = 4;
+  constexpr int num_calls = 1000;
+  Method<Dummy, int, int> m{"test"};
+  m.concurrent(true);
+  m.push().expects(1).persists().returns(1);
+
+  std::vector<int> sums(num_threads, 0);
+  std::vector<std::thread> threads{};
+  for (int t = 0; t < num_threads; ++t)
+  {
+    threads.emplace_back([&m, &sums, t] () {
+        for (int i = 0; i < num_calls; ++i)
+        {
+          sums[t] += *m.call(1);
+          sums[t] += *m.call(2);  // Fails and returns 0.
+        }
+      });
+  }
+  for (auto& thread : threads)
+  {
+    thread.join();
+  }
+
+  for (auto x : sums)
+  {
+    DRTEST_ASSERT_EQ(x, num_calls);
+  }
+  DRTEST_ASSERT(not m.verify());
+  DRTEST_ASSERT_EQ(m.num_failed_calls(), std::size_t{num_threads*num_calls});
+}
+
+DRTEST_BENCHMARK(stubCall)
+{
+  Method<Dummy, int, int> m{"test"};
+  m.push().expects().returns(1).persists();
+  drtest::measure([&m] () { drtest::doNotOptimize(m.call(1)); });
+}
+
+DRTEST_TEST(record)
+{
+  Method<Dummy, void, int, std::string> m{"test"};
+  m.push().expects(1, "foo").persists();
+  m.call(1, "foo");  // Not recorded.
+  m.record(3);
+  for (int i = 0; i < 5; ++i)
+  {
+    m.call(i, "foo");
+  }
+  DRTEST_ASSERT_EQ(m.num_recorded_calls(), std::size_t{5});
+  auto calls = m.calls();
+  DRTEST_ASSERT_EQ(calls.size(), std::size_t{3});
+  for (std::size_t i = 0; i < calls.size(); ++i)
+  {
+    DRTEST_ASSERT(calls[i].args);
+    DRTEST_ASSERT_EQ(std::get<0>(*calls[i].args), static_cast<int>(i) + 2);
+    DRTEST_ASSERT_EQ(std::get<1>(*calls[i].args), "foo");
+  }
+  DRTEST_ASSERT(calls[0].sequence < calls[1].sequence);
+  DRTEST_ASSERT(calls[1].sequence < calls[2].sequence);
+  DRTEST_ASSERT(calls[0].time <= calls[2].time);
+
+  auto records = m.makeCallRecords();
+  DRTEST_ASSERT_EQ(records.size(), std::size_t{3});
+  DRTEST_ASSERT_EQ(records[0].method, "test");
+  DRTEST_ASSERT_EQ(records[0].sequence, calls[0].sequence);
+  DRTEST_ASSERT_EQ(records[0].args.size(), std::size_t{2});
+
+  m.record(0);
+  m.call(1, "foo");
+  DRTEST_ASSERT(m.calls().empty());
+  DRTEST_ASSERT_EQ(m.num_recorded_calls(), std::size_t{0});
+}
+
+DRTEST_TEST(recordNonCopyable)
+{
+  Method<Dummy, void, std::unique_ptr<int>> m{"test"};
+  m.record(2);
+  m.call(std::make_unique<int>(1));
+  auto calls = m.calls();
+  DRTEST_ASSERT_EQ(calls.size(), std::size_t{1});
+  DRTEST_ASSERT(not calls[0].args);
+  DRTEST_ASSERT(m.makeCallRecords()[0].args.empty());
+}
+
+DRTEST_TEST(recordNonOwning)
+{
+  // Views are printed when they're recorded.
+  Method<Dummy, void, std::string_view> m{"test"};
+  m.record(2);
+  {
+    std::string s{"some argument"};
+    m.call(s);
+  }
+  auto calls = m.calls();
+  DRTEST_ASSERT_EQ(calls.size(), std::size_t{1});
+  DRTEST_ASSERT(not calls[0].args);
+  auto records = m.makeCallRecords();
+  DRTEST_ASSERT_EQ(records[0].args.size(), std::size_t{1});
+  DRTEST_ASSERT(records[0].args[0].find("some argument") != std::string::npos);
+
+  // So are other types which may hold views.
+  Method<Dummy, void, HoldsView> v{"test"};
+  v.record(2);
+  {
+    std::string s{"nested argument"};
+    v.call(HoldsView{s});
+  }
+  DRTEST_ASSERT(not v.calls()[0].args);
+  DRTEST_ASSERT(v.makeCallRecords()[0].args[0].find("nested argument") != std::string::npos);
+
+  // Shared pointers are not kept alive.
+  Method<Dummy, void, std::shared_ptr<int>> n{"test"};
+  n.record(2);
+  std::weak_ptr<int> w{};
+  {
+    auto p = std::make_shared<int>(1);
+    w = p;
+    n.call(p);
+  }
+  DRTEST_ASSERT(w.expired());
+  DRTEST_ASSERT_EQ(n.num_recorded_calls(), std::size_t{1});
+}
+
 DRTEST_TEST(nonCopyable)
 {
   Method<Dummy, std::unique_ptr<int>, int, std::unique_ptr<int>> m{"test"};
@@ -110,7 +469,7 @@ DRTEST_TEST(nonCopyable)
       .returns(std::make_unique<int>(2));
 
   DRTEST_ASSERT(not m.verify());
-  std::shared_ptr<std::unique_ptr<int>> sp = m.call(1, std::make_unique<int>(2));
+  std::unique_ptr<int>* sp = m.call(1, std::make_unique<int>(2));
   DRTEST_ASSERT(not m.verify());
   auto p = std::move(*sp);
   DRTEST_COMPARE(*p, 1);
@@ -0,0 +1,216 @@
+/* Copyright 2021 Ole Kliemann, Malte Kliemann
+ *
+ * This file is part of DrMock.
+ *
+ * DrMock is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DrMock is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DrMock.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <DrMock/Test.h>
+#include <DrMock/mock/Controller.h>
+#include <DrMock/mock/LogWriter.h>
+#include <DrMock/mock/MappedLog.h>
+#include <DrMock/mock/Method.h>
+#include <DrMock/mock/Recorder.h>
+#include <DrMock/utility/detail/Serializer.h>
+
+using namespace drmock;
+using drutility::detail::Serializer;
+
+class Dummy {};
+
+struct Point
+{
+  bool operator==(const Point&) const { return true; }
+};
+
+std::string
+logPath(const std::string& name)
+{
+  return (std::filesystem::temp_directory_path() / ("DrMockReplay." + name + ".log")).string();
+}
+
+DRTEST_TEST(serializer)
+{
+  using Tuple = std::tuple<int, std::string, std::vector<double>, std::optional<char>>;
+  Tuple expected{-3, "foo", {1.0, 2.5}, 'x'};
+  std::string buffer{};
+  Serializer<Tuple>::write(buffer, expected);
+  Serializer<std::pair<bool, std::string>>::write(buffer, {true, ""});
+
+  const char* pos = buffer.data();
+  const char* end = buffer.data() + buffer.size();
+  DRTEST_ASSERT(Serializer<Tuple>::read(pos, end) == expected);
+  DRTEST_ASSERT((Serializer<std::pair<bool, std::string>>::read(pos, end) == std::pair<bool, std::string>{true, ""}));
+  DRTEST_ASSERT(pos == end);
+  DRTEST_ASSERT_THROW(Serializer<int>::read(pos, end), std::runtime_error);
+
+  // Bytes other than 0 and 1 are rejected.
+  std::string corrupt{"\x02"};
+  pos = corrupt.data();
+  end = corrupt.data() + corrupt.size();
+  DRTEST_ASSERT_THROW(Serializer<bool>::read(pos, end), std::runtime_error);
+
+  DRTEST_ASSERT(not drutility::detail::is_serializable_v<Point>);
+  DRTEST_ASSERT((not drutility::detail::is_serializable_v<std::vector<Point>>));
+}
+
+DRTEST_TEST(roundTrip)
+{
+  auto path = logPath("roundTrip");
+  {
+    auto writer = std::make_shared<LogWriter>(path);
+    Recorder<int, int, const std::string&> f{
+        writer, "f",
+        [] (int x, const std::string& s) { return x + static_cast<int>(s.size()); }
+      };
+    Recorder<void, float> g{
+        writer, "g",
+        [] (float x) { if (x < 0) { throw std::invalid_argument{"negative"}; } }
+      };
+    DRTEST_ASSERT_EQ(f(1, "foo"), 4);
+    g(1.0f);
+    DRTEST_ASSERT_THROW(g(-1.0f), std::invalid_argument);
+    DRTEST_ASSERT_EQ(f(2, ""), 2);
+  }
+
+  auto log = std::make_shared<MappedLog>(path);
+  Method<Dummy, int, int, std::string> f{"f"};
+  Method<Dummy, void, float> g{"g"};
+  f.replay(log);
+  g.replay(log);
+  DRTEST_ASSERT(not f.verify());
+  DRTEST_ASSERT(not g.verify());
+
+  // Calls of different methods needn't be replayed in the recorded
+  // order.
+  g.call(1.0f);
+  auto first = f.call(1, "foo");
+  DRTEST_ASSERT_EQ(*first, 4);
+  DRTEST_ASSERT_THROW(g.call(-1.0f), std::runtime_error);
+  DRTEST_ASSERT(g.verify());
+  DRTEST_ASSERT_EQ(*f.call(2, ""), 2);
+  DRTEST_ASSERT(f.verify());
+  // Earlier results are not overwritten.
+  DRTEST_ASSERT_EQ(*first, 4);
+
+  // The replay is exhausted.
+  f.call(2, "");
+  DRTEST_ASSERT(not f.verify());
+  std::filesystem::remove(path);
+}
+
+DRTEST_TEST(unknownException)
+{
+  auto path = logPath("unknownException");
+  {
+    auto writer = std::make_shared<LogWriter>(path);
+    Recorder<void, int> f{writer, "f", [] (int x) { throw x; }};
+    DRTEST_ASSERT_THROW(f(1), int);
+  }
+
+  auto log = std::make_shared<MappedLog>(path);
+  Method<Dummy, void, int> f{"f"};
+  f.replay(log);
+  DRTEST_ASSERT_THROW(f.call(1), std::runtime_error);
+  DRTEST_ASSERT(f.verify());
+  std::filesystem::remove(path);
+}
+
+DRTEST_TEST(mismatch)
+{
+  auto path = logPath("mismatch");
+  {
+    auto writer = std::make_shared<LogWriter>(path);
+    Recorder<int, int> f{writer, "f", [] (int x) { return 2*x; }};
+    f(1);
+    f(2);
+  }
+
+  auto log = std::make_shared<MappedLog>(path);
+  auto f = std::make_shared<Method<Dummy, int, int>>("f");
+  Controller controller{{f}};
+  auto& replay = f->replay(log);
+  DRTEST_ASSERT(not controller.verify());
+
+  // A mismatch doesn't advance the replay.
+  DRTEST_ASSERT_EQ(*f->call(2), 0);
+  DRTEST_ASSERT_EQ(*f->call(1), 2);
+  DRTEST_ASSERT_EQ(*f->call(2), 4);
+  DRTEST_ASSERT(replay.is_exhausted());
+  DRTEST_ASSERT_EQ(f->num_failed_calls(), std::size_t{1});
+  DRTEST_ASSERT(not controller.verify());
+  std::filesystem::remove(path);
+}
+
+DRTEST_TEST(stream)
+{
+  auto path = logPath("stream");
+  constexpr int n = 100000;
+  {
+    auto writer = std::make_shared<LogWriter>(path);
+    Recorder<std::string, int> f{writer, "f", [] (int x) { return std::to_string(x); }};
+    Recorder<void> g{writer, "g", [] () {}};
+    for (int i = 0; i < n; ++i)
+    {
+      f(i);
+      g();
+    }
+  }
+
+  Method<Dummy, std::string, int> f{"f"};
+  Method<Dummy, void> g{"g"};
+  auto log = std::make_shared<MappedLog>(path);
+  f.replay(log);
+  g.replay(log);
+  int failures = 0;
+  for (int i = 0; i < n; ++i)
+  {
+    failures += (*f.call(i) != std::to_string(i));
+    g.call();
+  }
+  DRTEST_ASSERT_EQ(failures, 0);
+  DRTEST_ASSERT(f.verify());
+  DRTEST_ASSERT(g.verify());
+  std::filesystem::remove(path);
+}
+
+DRTEST_TEST(notSerializable)
+{
+  auto path = logPath("notSerializable");
+  std::make_shared<LogWriter>(path);
+  Method<Dummy, void, Point> f{"f"};
+  DRTEST_ASSERT_THROW(f.replay(std::make_shared<MappedLog>(path)), std::logic_error);
+  std::filesystem::remove(path);
+}
+
+DRTEST_TEST(invalidLog)
+{
+  auto path = logPath("invalidLog");
+  {
+    std::ofstream stream{path};
+    stream << "foo";
+  }
+  DRTEST_ASSERT_THROW(MappedLog{path}, std::runtime_error);
+  std::filesystem::remove(path);
+  DRTEST_ASSERT_THROW(MappedLog{path}, std::runtime_error);
+}
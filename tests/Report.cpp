@@ -0,0 +1,71 @@
+/* Copyright 2021 Ole Kliemann, Malte Kliemann
+ *
+ * This file is part of DrMock.
+ *
+ * DrMock is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DrMock is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DrMock.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <DrMock/Test.h>
+
+using namespace drtest::detail;
+
+std::vector<TestResult> makeResults()
+{
+  std::vector<TestResult> results{};
+  results.push_back({"a", "", "", Status::pass, "", 0.5, 0.25});
+  results.push_back({"b", "row <1>", "", Status::fail, "x \"==\" y\n", 1.0, 1.0});
+  results.push_back({"b", "row 2", "", Status::skip, "", 0.0, 0.0});
+  results.push_back({"init", "", "b", Status::xfail, "", 0.0, 0.0});
+  return results;
+}
+
+DRTEST_TEST(json)
+{
+  std::stringstream s{};
+  writeJsonReport(s, "suite", makeResults());
+  std::string json = s.str();
+  DRTEST_ASSERT(json.find("\"name\": \"suite\"") != std::string::npos);
+  DRTEST_ASSERT(json.find(
+      "{\"test\": \"a\", \"row\": \"\", \"status\": \"pass\", \"wall_time\": 0.5, \"cpu_time\": 0.25}"
+    ) != std::string::npos);
+  DRTEST_ASSERT(json.find("\"message\": \"x \\\"==\\\" y\\n\"") != std::string::npos);
+  DRTEST_ASSERT(json.find("\"context\": \"b\", \"status\": \"xfail\"") != std::string::npos);
+}
+
+DRTEST_TEST(junit)
+{
+  std::stringstream s{};
+  writeJUnitReport(s, "suite", makeResults());
+  std::string xml = s.str();
+  DRTEST_ASSERT(xml.find(
+      "<testsuite name=\"suite\" tests=\"4\" failures=\"1\" skipped=\"1\" time=\"1.5\">"
+    ) != std::string::npos);
+  DRTEST_ASSERT(xml.find("<testcase classname=\"a\" name=\"a\" time=\"0.5\"/>") != std::string::npos);
+  DRTEST_ASSERT(xml.find(
+      "<testcase classname=\"b\" name=\"row &lt;1&gt;\" time=\"1\">\n"
+      "    <failure message=\"x &quot;==&quot; y&#10;\"/>"
+    ) != std::string::npos);
+  DRTEST_ASSERT(xml.find("<skipped/>") != std::string::npos);
+  DRTEST_ASSERT(xml.find("name=\"init (b)\"") != std::string::npos);
+}
+
+DRTEST_TEST(escape)
+{
+  DRTEST_ASSERT_EQ(escapeJson("a\"b\\c\td"), std::string{"a\\\"b\\\\c\\td"});
+  DRTEST_ASSERT_EQ(escapeXml("<a & 'b'>\x01"), std::string{"&lt;a &amp; 'b'&gt;"});
+}
@@ -17,6 +17,8 @@
 */
 
 #include <string>
+#include <thread>
+#include <vector>
 
 #include <DrMock/Test.h>
 #include <DrMock/mock/AlmostEqual.h>
@@ -38,10 +40,7 @@ public:
 };
 
 template<typename ReturnType>
-using Result = std::pair<
-    std::shared_ptr<ReturnType>,
-    std::shared_ptr<AbstractSignal<Dummy>>
-  >;
+using Result = std::pair<ReturnType*, AbstractSignal<Dummy>*>;
 
 DRTEST_TEST(noSuchState)
 {
@@ -706,3 +705,69 @@ DRTEST_TEST(usingCustomMatcher)
   DRTEST_ASSERT(sp);
   DRTEST_ASSERT_EQ(*sp, 2);
 }
+
+DRTEST_TEST(concurrentTransitions)
+{
+  // Every call advances the state by one, so no call may be lost when
+  // calling concurrently.
+  constexpr int num_threads = 4;
+  constexpr int num_calls = 1000;
+  auto so = std::make_shared<StateObject>();
+  StateBehavior<Dummy, int, int> b{so};
+  for (int i = 0; i < num_threads*num_calls; ++i)
+  {
+    b.transition(std::to_string(i), std::to_string(i + 1), 1);
+    b.returns(std::to_string(i + 1), int{i + 1});
+  }
+  so->set("0");
+
+  std::vector<std::vector<int>> results(num_threads);
+  std::vector<std::thread> threads{};
+  for (int t = 0; t < num_threads; ++t)
+  {
+    threads.emplace_back([&b, &results, t] () {
+        for (int i = 0; i < num_calls; ++i)
+        {
+          auto result = b.call(1);
+          results[t].push_back(*std::get<Result<int>>(result).first);
+        }
+      });
+  }
+  for (auto& thread : threads)
+  {
+    thread.join();
+  }
+
+  DRTEST_ASSERT_EQ(so->get(), std::to_string(num_threads*num_calls));
+  // Every call sees the state it transitioned to.
+  std::vector<int> seen(num_threads*num_calls + 1, 0);
+  for (const auto& v : results)
+  {
+    for (auto x : v)
+    {
+      ++seen[x];
+    }
+  }
+  for (int i = 1; i <= num_threads*num_calls; ++i)
+  {
+    DRTEST_ASSERT_EQ(seen[i], 1);
+  }
+}
+
+DRTEST_TEST(transitionStatic)
+{
+  auto so = std::make_shared<StateObject>();
+  StateBehavior<Dummy, int, int, float> b{so};
+  b.transition_static("", "state1", eq(1), any());
+  b.transition_static("slot", "", "state2", any(), almost(2.0f));
+  b.returns("state1", 1);
+
+  auto result = b.call(2, 0.0f);
+  DRTEST_ASSERT(std::holds_alternative<std::monostate>(result));
+  DRTEST_COMPARE(so->get("slot"), std::string{});
+
+  result = b.call(1, 2.0f);
+  DRTEST_ASSERT(std::holds_alternative<Result<int>>(result));
+  DRTEST_COMPARE(*std::get<Result<int>>(result).first, 1);
+  DRTEST_COMPARE(so->get("slot"), std::string{"state2"});
+}
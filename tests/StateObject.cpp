@@ -40,3 +40,53 @@ DRTEST_TEST(testStateObject)
   DRTEST_COMPARE(so.get("some slot 1"), std::string{"test 1"});
   DRTEST_COMPARE(so.get("some slot 2"), std::string{"test 2"});
 }
+
+DRTEST_TEST(ids)
+{
+  StateObject so{};
+  DRTEST_ASSERT_EQ(so.slotId(""), std::size_t{0});
+  DRTEST_ASSERT_EQ(so.stateId(""), std::size_t{0});
+
+  auto slot = so.slotId("slot");
+  auto state = so.stateId("state");
+  DRTEST_ASSERT_EQ(so.slotId("slot"), slot);
+  DRTEST_ASSERT_EQ(so.stateId("state"), state);
+  DRTEST_ASSERT_EQ(so.stateName(state), std::string{"state"});
+  DRTEST_ASSERT_EQ(so.getState(slot), std::size_t{0});
+
+  // Names and IDs are interchangeable.
+  so.setState(slot, state);
+  DRTEST_COMPARE(so.get("slot"), std::string{"state"});
+  so.set("slot", "other");
+  DRTEST_ASSERT_EQ(so.getState(slot), so.stateId("other"));
+  DRTEST_COMPARE(so.get(), std::string{});
+}
+
+DRTEST_TEST(transition)
+{
+  StateObject so{};
+  auto slot = so.slotId("slot");
+  auto foo = so.stateId("foo");
+  auto bar = so.stateId("bar");
+  DRTEST_ASSERT(not so.transition(slot, foo, bar));
+  DRTEST_ASSERT_EQ(so.getState(slot), so.stateId(""));
+  DRTEST_ASSERT(so.transition(slot, so.stateId(""), foo));
+  DRTEST_ASSERT(so.transition(slot, foo, bar));
+  DRTEST_COMPARE(so.get("slot"), std::string{"bar"});
+}
+
+DRTEST_TEST(manySlots)
+{
+  // Registering slots doesn't move the states of other slots.
+  StateObject so{};
+  const auto& state = so.get("slot");
+  for (int i = 0; i < 1000; ++i)
+  {
+    so.set(std::to_string(i), std::to_string(i));
+  }
+  DRTEST_COMPARE(state, std::string{});
+  for (int i = 0; i < 1000; ++i)
+  {
+    DRTEST_COMPARE(so.get(std::to_string(i)), std::to_string(i));
+  }
+}
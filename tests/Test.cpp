@@ -21,6 +21,11 @@
 #endif /* _MSC_VER */
 
 #include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
 
 #define USING_DRTEST
 #include <DrMock/Test.h>
@@ -190,6 +195,49 @@ DRTEST_TEST(test_with_data_2)
 DRTEST_TEST(test_without_data)
 {
   DRTEST_ASSERT_THROW(DRTEST_FETCH(std::string, col1), std::logic_error);
+  DRTEST_ASSERT_THROW(DRTEST_FETCH_REF(std::string, col1), std::logic_error);
+}
+
+DRTEST_DATA(test_fetch_ref)
+{
+  drtest::addColumns<std::vector<int>, std::size_t>("values", "size");
+  drtest::addRow("empty", std::vector<int>{}, std::size_t{0});
+  drtest::addRow("large", std::vector<int>(10000, 1), std::size_t{10000});
+}
+
+DRTEST_TEST(test_fetch_ref)
+{
+  DRTEST_FETCH_REF(std::vector<int>, values);
+  DRTEST_FETCH(std::size_t, size);
+  DRTEST_ASSERT_EQ(values.size(), size);
+
+  // The reference points into the table.
+  DRTEST_ASSERT_EQ(&values, &*drtest::column<std::vector<int>>("values"));
+}
+
+DRTEST_DATA(test_column_handle)
+{
+  drtest::addColumns<std::string, int>("s", "n");
+  drtest::addRow("a", std::string{"a"}, 1);
+  drtest::addRow("bb", std::string{"bb"}, 2);
+  drtest::addRow("no n", std::string{"ccc"});
+}
+
+DRTEST_TEST(test_column_handle)
+{
+  auto s = drtest::column<std::string>("s");
+  auto n = drtest::column<int>("n");
+  DRTEST_ASSERT_EQ(&*s, &s.get());
+  if (*s == "ccc")
+  {
+    DRTEST_ASSERT_THROW(n.get(), std::logic_error);
+  }
+  else
+  {
+    DRTEST_ASSERT_EQ(s->size(), static_cast<std::size_t>(*n));
+  }
+  DRTEST_ASSERT_THROW(drtest::column<int>("s"), std::logic_error);
+  DRTEST_ASSERT_THROW(drtest::column<int>("x"), std::logic_error);
 }
 
 struct A
@@ -207,6 +255,126 @@ DRTEST_TEST(streamIfStreamable)
   DRTEST_ASSERT_EQ(A{}, A{});
 }
 
+struct CountStreams
+{
+  bool operator==(const CountStreams&) const
+  {
+    return false;
+  }
+
+  static inline int count = 0;
+};
+
+std::ostream& operator<<(std::ostream& os, const CountStreams&)
+{
+  ++CountStreams::count;
+  return os << "CountStreams";
+}
+
+namespace drutility { namespace detail {
+
+template<>
+struct is_self_contained<CountStreams> : std::true_type {};
+
+}} // namespace drutility::detail
+
+struct HoldsPointer
+{
+  bool operator==(const HoldsPointer& other) const
+  {
+    return s == other.s;
+  }
+
+  const std::string* s;
+};
+
+std::ostream& operator<<(std::ostream& os, const HoldsPointer& p)
+{
+  return os << (p.s ? *p.s : "null");
+}
+
+DRTEST_TEST(lazyTestFailure)
+{
+  CountStreams::count = 0;
+  DRTEST_ASSERT_TEST_FAIL(DRTEST_ASSERT_EQ(CountStreams{}, CountStreams{}));
+  DRTEST_ASSERT_EQ(CountStreams::count, 0);
+
+  try
+  {
+    DRTEST_ASSERT_EQ(CountStreams{}, CountStreams{});
+  }
+  catch(const drtest::detail::TestFailure& e)
+  {
+    std::string what = e.what();
+    DRTEST_ASSERT_EQ(CountStreams::count, 2);
+    DRTEST_ASSERT(what.find("CountStreams") != std::string::npos);
+
+    // The message is cached.
+    DRTEST_ASSERT_EQ(std::string{e.what()}, what);
+    DRTEST_ASSERT_EQ(CountStreams::count, 2);
+  }
+
+  // Operands which can't be copied are rendered immediately.
+  auto p = std::make_unique<int>(1);
+  DRTEST_ASSERT_TEST_FAIL(DRTEST_ASSERT_EQ(p, nullptr));
+
+  // So are pointers, whose pointees may be gone when the message is
+  // rendered.
+  std::string what{};
+  try
+  {
+    std::string local{"local"};
+    DRTEST_ASSERT_EQ(std::string_view{local}, "other");
+  }
+  catch(const drtest::detail::TestFailure& e)
+  {
+    what = e.what();
+  }
+  DRTEST_ASSERT(what.find("local") != std::string::npos);
+
+  // And so are types which aren't known to be self-contained.
+  what.clear();
+  try
+  {
+    std::string local{"nested"};
+    DRTEST_ASSERT_EQ(HoldsPointer{&local}, HoldsPointer{nullptr});
+  }
+  catch(const drtest::detail::TestFailure& e)
+  {
+    what = e.what();
+  }
+  DRTEST_ASSERT(what.find("nested") != std::string::npos);
+}
+
+DRTEST_TEST(lazyTestFailureConcurrent)
+{
+  CountStreams::count = 0;
+  try
+  {
+    DRTEST_ASSERT_EQ(CountStreams{}, CountStreams{});
+  }
+  catch(const drtest::detail::TestFailure& e)
+  {
+    // Copies share the message, which is rendered exactly once.
+    std::vector<drtest::detail::TestFailure> copies(8, e);
+    std::vector<std::string> whats(copies.size());
+    std::vector<std::thread> threads{};
+    for (std::size_t i = 0; i < copies.size(); ++i)
+    {
+      threads.emplace_back([&copies, &whats, i] () { whats[i] = copies[i].what(); });
+    }
+    for (auto& t : threads)
+    {
+      t.join();
+    }
+    DRTEST_ASSERT_EQ(CountStreams::count, 2);
+    for (const auto& what : whats)
+    {
+      DRTEST_ASSERT_EQ(what, whats.front());
+    }
+  }
+}
+
 #if defined(__unix__) || defined(__APPLE__)
 
 DRTEST_TEST(death_success)
@@ -0,0 +1,197 @@
+/* Copyright 2021 Ole Kliemann, Malte Kliemann
+ *
+ * This file is part of DrMock.
+ *
+ * DrMock is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DrMock is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DrMock.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <DrMock/Test.h>
+
+using namespace drtest::detail;
+
+class NullLogger final : public drutility::ILogger
+{
+public:
+  void logMessage(
+      bool,
+      const std::string&,
+      const std::string&,
+      int,
+      const std::ostream&
+    ) override
+  {}
+};
+
+// Run `test` without logging.
+void runQuietly(TestObject& test)
+{
+  auto previous = drutility::Singleton<drutility::ILogger>::get();
+  drutility::Singleton<drutility::ILogger>::set(std::make_shared<NullLogger>());
+  test.runTest();
+  drutility::Singleton<drutility::ILogger>::set(previous);
+}
+
+DRTEST_TEST(fetchData)
+{
+  TestObject test{"test"};
+  test.addColumn<int>("x");
+  test.addColumn<std::string>("s");
+  for (int i = 0; i < 1000; ++i)
+  {
+    test.addRow(std::to_string(i), i, std::to_string(2*i));
+  }
+
+  int sum = 0;
+  test.setTestFunc([&] () {
+      int x = test.fetchData<int>("x");
+      DRTEST_ASSERT_EQ(test.fetchData<std::string>("s"), std::to_string(2*x));
+      sum += x;
+    });
+  runQuietly(test);
+  DRTEST_ASSERT_EQ(test.num_failures(), 0u);
+  DRTEST_ASSERT_EQ(sum, 499500);
+}
+
+DRTEST_TEST(fetchDataCached)
+{
+  // The cache is shared by two tests with different column layouts.
+  TestObject::ColumnCache cache{};
+  TestObject first{"first"};
+  first.addColumn<int>("x");
+  first.addRow("row", 1);
+  TestObject second{"second"};
+  second.addColumn<std::string>("s");
+  second.addColumn<int>("x");
+  second.addRow("row", std::string{"s"}, 2);
+
+  int sum = 0;
+  first.setTestFunc([&] () { sum += first.fetchData<int>("x", cache); });
+  second.setTestFunc([&] () { sum += 10*second.fetchData<int>("x", cache); });
+  runQuietly(first);
+  DRTEST_ASSERT_EQ(cache.index, 0u);
+  runQuietly(second);
+  DRTEST_ASSERT_EQ(cache.index, 1u);
+  runQuietly(first);
+  DRTEST_ASSERT_EQ(sum, 22);
+  DRTEST_ASSERT_EQ(first.num_failures(), 0u);
+  DRTEST_ASSERT_EQ(second.num_failures(), 0u);
+}
+
+DRTEST_TEST(fetchCurrent)
+{
+  TestObject::ColumnCache cache{};
+  TestObject first{"first"};
+  first.addColumn<int>("x");
+  first.addRow("row", 1);
+  TestObject second{"second"};
+  second.addColumn<std::string>("s");
+  second.addColumn<int>("x");
+  second.addRow("row", std::string{"s"}, 2);
+
+  int sum = 0;
+  auto fetch = [&] (int factor) {
+      return [&sum, &cache, factor] () {
+          sum += factor*TestObject::fetchCurrentRef<int>("x", cache);
+        };
+    };
+  first.setTestFunc(fetch(1));
+  second.setTestFunc(fetch(10));
+  auto previous = TestObject::current();
+  TestObject::setCurrent(&first);
+  runQuietly(first);
+  TestObject::setCurrent(&second);
+  runQuietly(second);
+  TestObject::setCurrent(previous);
+  DRTEST_ASSERT_EQ(sum, 21);
+  DRTEST_ASSERT_EQ(cache.index, 1u);
+  DRTEST_ASSERT_EQ(first.num_failures(), 0u);
+  DRTEST_ASSERT_EQ(second.num_failures(), 0u);
+
+  // No test is running on a new thread.
+  bool thrown = false;
+  std::thread{[&thrown, &cache] () {
+      try
+      {
+        TestObject::fetchCurrentRef<int>("x", cache);
+      }
+      catch (const std::logic_error&)
+      {
+        thrown = true;
+      }
+    }}.join();
+  DRTEST_ASSERT(thrown);
+}
+
+DRTEST_TEST(fetchDataErrors)
+{
+  TestObject test{"test"};
+  test.addColumn<int>("x");
+  test.addColumn<int>("y");
+  test.addRow("full", 1, 2);
+  test.addRow("partial", 3);
+
+  std::vector<std::string> errors{};
+  test.setTestFunc([&] () {
+      for (const auto& column : {"y", "z"})
+      {
+        try
+        {
+          test.fetchData<int>(column);
+        }
+        catch(const std::logic_error& e)
+        {
+          errors.push_back(e.what());
+        }
+      }
+      try
+      {
+        test.fetchData<double>("x");
+      }
+      catch(const std::logic_error& e)
+      {
+        errors.push_back(e.what());
+      }
+    });
+  runQuietly(test);
+  // Missing value in row "partial", missing column "z" in both rows and
+  // type mismatch in both rows.
+  DRTEST_ASSERT_EQ(errors.size(), 5u);
+  DRTEST_ASSERT_THROW(test.fetchData<int>("x"), std::logic_error);
+}
+
+DRTEST_TEST(addRowErrors)
+{
+  TestObject test{"test"};
+  test.addColumn<int>("x");
+  test.addColumn<std::string>("s");
+  DRTEST_ASSERT_THROW(test.addColumn<int>("x"), std::logic_error);
+  DRTEST_ASSERT_THROW(test.addRow("row", 1, 2), std::logic_error);
+  DRTEST_ASSERT_THROW(test.addRow("", 1, std::string{}), std::logic_error);
+  DRTEST_ASSERT_THROW(test.tagRow("row", drtest::tags::skip), std::logic_error);
+
+  // The rejected row was not added.
+  test.addRow("row", 1, std::string{});
+  DRTEST_ASSERT_THROW(test.addRow("row", 1, std::string{}), std::logic_error);
+  test.tagRow("row", drtest::tags::skip);
+
+  bool called = false;
+  test.setTestFunc([&] () { called = true; });
+  runQuietly(test);
+  DRTEST_ASSERT(not called);
+}
@@ -16,6 +16,13 @@
  * along with DrMock.  If not, see <https://www.gnu.org/licenses/>.
 */
 
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
 #include <DrMock/Test.h>
 #include <DrMock/utility/detail/TypeTraits.h>
 
@@ -64,6 +71,24 @@ DRTEST_TEST(is_base_of_smart_pointer_unique)
   DRTEST_ASSERT((not is_base_of_smart_ptr_v<base, other>));
 }
 
+DRTEST_TEST(is_self_contained)
+{
+  DRTEST_ASSERT((is_self_contained_v<int>));
+  DRTEST_ASSERT((is_self_contained_v<const double>));
+  DRTEST_ASSERT((is_self_contained_v<std::string>));
+  DRTEST_ASSERT((is_self_contained_v<std::vector<std::map<int, std::string>>>));
+  DRTEST_ASSERT((is_self_contained_v<std::tuple<int, std::optional<std::string>>>));
+  DRTEST_ASSERT((not is_self_contained_v<const char*>));
+  DRTEST_ASSERT((not is_self_contained_v<std::string_view>));
+  DRTEST_ASSERT((not is_self_contained_v<std::vector<std::string_view>>));
+  DRTEST_ASSERT((not is_self_contained_v<std::pair<const char*, int>>));
+  DRTEST_ASSERT((not is_self_contained_v<std::optional<std::string_view>>));
+  DRTEST_ASSERT((not is_self_contained_v<std::tuple<int&>>));
+  DRTEST_ASSERT((not is_self_contained_v<std::shared_ptr<Base>>));
+  DRTEST_ASSERT((not is_self_contained_v<std::vector<int>::const_iterator>));
+  DRTEST_ASSERT((not is_self_contained_v<Base>));
+}
+
 DRTEST_TEST(is_base_of_tuple)
 {
   using base = std::unique_ptr<Base>;
@@ -0,0 +1,75 @@
+/* Copyright 2021 Ole Kliemann, Malte Kliemann
+ *
+ * This file is part of DrMock.
+ *
+ * DrMock is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DrMock is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DrMock.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <DrMock/Test.h>
+#include "mock/ExternTemplatesAMock.h"
+#include "mock/ExternTemplatesBMock.h"
+
+using namespace outer::inner;
+
+// The mocks share the parameter lists of `f` and `g`, whose templates
+// are instantiated in the shared unit of the library.
+
+DRTEST_TEST(sharedParameters)
+{
+  ExternTemplatesAMock a{};
+  ExternTemplatesBMock b{};
+  std::vector<float> v{1.0f, 2.0f};
+  std::vector<float> w{};
+  a.mock.f().push().expects(1, v).times(1).returns(3);
+  b.mock.f().push().expects(2, w).times(1);
+  a.mock.g().push().times(1);
+  b.mock.g().push().times(1).returns(1.5f);
+
+  DRTEST_ASSERT_EQ(a.f(1, v), 3);
+  b.f(2, w);
+  a.g();
+  DRTEST_ASSERT_EQ(b.g(), 1.5f);
+  DRTEST_VERIFY_MOCK(a.mock);
+  DRTEST_VERIFY_MOCK(b.mock);
+}
+
+DRTEST_TEST(failsOnMismatch)
+{
+  ExternTemplatesAMock a{};
+  ExternTemplatesBMock b{};
+  std::vector<float> v{};
+  a.mock.f().push().expects(1, v).times(1).returns(3);
+  b.mock.f().push().expects(1, v).times(1);
+
+  a.f(1, v);
+  b.f(2, v);
+  DRTEST_VERIFY_MOCK(a.mock);
+  DRTEST_ASSERT_TEST_FAIL(DRTEST_VERIFY_MOCK(b.mock));
+}
+
+DRTEST_TEST(references)
+{
+  // Parameter lists with reference types aren't shared.
+  ExternTemplatesAMock a{};
+  ExternTemplatesBMock b{};
+  std::string foo{"foo"};
+  std::string bar{"bar"};
+  a.mock.h().push().expects(foo).times(1).returns(bar);
+  b.mock.h().push().expects(foo).times(1);
+
+  DRTEST_ASSERT_EQ(a.h(foo), bar);
+  b.h(foo);
+  DRTEST_VERIFY_MOCK(a.mock);
+  DRTEST_VERIFY_MOCK(b.mock);
+}